@@ -31,43 +31,89 @@
 #ifndef FASTNOISE_H
 #define FASTNOISE_H
 
+#include <algorithm>
 #include <vector>
 
-// Uncomment the line below to use doubles throughout FastNoise instead of floats
-#define FN_USE_DOUBLES
-
 #define FN_CELLULAR_INDEX_MAX 3
 
-#ifdef FN_USE_DOUBLES
-typedef double FN_DECIMAL;
-#else
-typedef float FN_DECIMAL;
-#endif
+template <typename T> struct FastNoiseLUT;
+template <typename T> struct FastNoiseBatchParams;
 
-class FastNoise
+// The settings shared by the engines of all precisions
+class FastNoiseBase
 {
 public:
-  explicit FastNoise(int seed = 1337) { SetSeed(seed); CalculateFractalBounding(); CalculateSpectralGain();}
-
-  enum NoiseType { Value, ValueFractal, Perlin, PerlinFractal, Simplex, SimplexFractal, Cellular, WhiteNoise, Cubic, CubicFractal };
+  enum NoiseType { Value, ValueFractal, Perlin, PerlinFractal, Simplex, SimplexFractal, Cellular, WhiteNoise, Cubic, CubicFractal, CellularFractal };
   enum Interp { Linear, Hermite, Quintic };
   enum FractalType { FBM, Billow, RigidMulti };
   enum CellularDistanceFunction { Euclidean, Manhattan, Natural };
   enum CellularReturnType { CellValue, NoiseLookup, Distance, Distance2, Distance2Add, Distance2Sub, Distance2Mul, Distance2Div };
 
-  // Sets seed used for all noise types
-  // Default: 1337
-  void SetSeed(int seed);
+  // Vector width used by the batch methods. Defaults to the widest supported
+  // by the CPU (SSE2, AVX2, or AVX-512 on x86), setting a wider one than that
+  // has no effect
+  enum SIMDLevel { SIMDScalar, SIMD128, SIMD256, SIMD512 };
+  static SIMDLevel GetSIMDLevel();
+  static void SetSIMDLevel(SIMDLevel level);
+
+  // How a seed is expanded into the permutation tables. Legacy shuffles with
+  // std::mt19937_64 and reproduces the tables of earlier versions, SplitMix
+  // shuffles with the much cheaper SplitMix64 generator
+  enum SeedMode { SeedLegacy, SeedSplitMix };
+};
+
+// The noise engine, templated on the floating point type used for all
+// calculations and lookup tables. It is instantiated for float and double at
+// the end of FastNoise.cpp
+template <typename T>
+class FastNoiseT : public FastNoiseBase
+{
+public:
+  explicit FastNoiseT(int seed = 1337) { SetSeed(seed); CalculateFractalBounding(); CalculateSpectralGain();}
+
+  // Copies the settings of an engine of another precision. The cellular noise
+  // lookup is not carried over
+  template <typename U>
+  explicit FastNoiseT(const FastNoiseT<U>& other) :
+    m_frequency(T(other.m_frequency)),
+    m_interp(other.m_interp),
+    m_noiseType(other.m_noiseType),
+    m_octaves(other.m_octaves),
+    m_lacunarity(T(other.m_lacunarity)),
+    m_gain(T(other.m_gain)),
+    m_fractalType(other.m_fractalType),
+    m_cellularDistanceFunction(other.m_cellularDistanceFunction),
+    m_cellularReturnType(other.m_cellularReturnType),
+    m_cellularDistanceIndex0(other.m_cellularDistanceIndex0),
+    m_cellularDistanceIndex1(other.m_cellularDistanceIndex1),
+    m_cellularJitter(T(other.m_cellularJitter)),
+    m_gradientPerturbAmp(T(other.m_gradientPerturbAmp))
+  {
+    m_seed = other.m_seed;
+    m_seedMode = other.m_seedMode;
+    std::copy(other.m_perm, other.m_perm + 512, m_perm);
+    std::copy(other.m_perm12, other.m_perm12 + 512, m_perm12);
+    CalculateFractalBounding();
+    CalculateSpectralGain();
+  }
+
+  // Sets seed used for all noise types. The permutation tables of recently
+  // used seeds are cached so this is cheap when a seed is reused
+  // Default: 1337, SeedLegacy
+  void SetSeed(int seed, SeedMode mode = SeedLegacy);
 
   // Returns seed used for all noise types
   int GetSeed() const { return m_seed; }
 
+  // Returns how the seed was expanded into the permutation tables
+  SeedMode GetSeedMode() const { return m_seedMode; }
+
   // Sets frequency for all noise types
   // Default: 0.01
-  void SetFrequency(FN_DECIMAL frequency) { m_frequency = frequency; }
+  void SetFrequency(T frequency) { m_frequency = frequency; }
 
   // Returns frequency used for all noise types
-  FN_DECIMAL GetFrequency() const { return m_frequency; }
+  T GetFrequency() const { return m_frequency; }
 
   // Changes the interpolation method used to smooth between noise values
   // Possible interpolation methods (lowest to highest quality) :
@@ -97,17 +143,17 @@ public:
 
   // Sets octave lacunarity for all fractal noise types
   // Default: 2.0
-  void SetFractalLacunarity(FN_DECIMAL lacunarity) { m_lacunarity = lacunarity; CalculateSpectralGain();}
+  void SetFractalLacunarity(T lacunarity) { m_lacunarity = lacunarity; CalculateSpectralGain();}
 
   // Returns octave lacunarity for all fractal noise types
-  FN_DECIMAL GetFractalLacunarity() const { return m_lacunarity; }
+  T GetFractalLacunarity() const { return m_lacunarity; }
 
   // Sets octave gain for all fractal noise types
   // Default: 0.5
-  void SetFractalGain(FN_DECIMAL gain) { m_gain = gain; CalculateFractalBounding(); }
+  void SetFractalGain(T gain) { m_gain = gain; CalculateFractalBounding(); }
 
   // Returns octave gain for all fractal noise types
-  FN_DECIMAL GetFractalGain() const { return m_gain; }
+  T GetFractalGain() const { return m_gain; }
 
   // Sets method for combining octaves in all fractal noise types
   // Default: FBM
@@ -134,10 +180,10 @@ public:
 
   // Noise used to calculate a cell value if cellular return type is NoiseLookup
   // The lookup value is acquired through GetNoise() so ensure you SetNoiseType() on the noise lookup, value, Perlin or simplex is recommended
-  void SetCellularNoiseLookup(FastNoise* noise) { m_cellularNoiseLookup = noise; }
+  void SetCellularNoiseLookup(FastNoiseT* noise) { m_cellularNoiseLookup = noise; }
 
   // Returns the noise used to calculate a cell value if the cellular return type is NoiseLookup
-  FastNoise* GetCellularNoiseLookup() const { return m_cellularNoiseLookup; }
+  FastNoiseT* GetCellularNoiseLookup() const { return m_cellularNoiseLookup; }
 
   // Sets the 2 distance indices used for distance2 return types
   // Default: 0, 1
@@ -151,163 +197,229 @@ public:
   // Sets the maximum distance a cellular point can move from its grid position
   // Setting this high will make artifacts more common
   // Default: 0.45
-  void SetCellularJitter(FN_DECIMAL cellularJitter) { m_cellularJitter = cellularJitter; }
+  void SetCellularJitter(T cellularJitter) { m_cellularJitter = cellularJitter; }
 
   // Returns the maximum distance a cellular point can move from its grid position
-  FN_DECIMAL GetCellularJitter() const { return m_cellularJitter; }
+  T GetCellularJitter() const { return m_cellularJitter; }
 
   // Sets the maximum warp distance from original location when using GradientPerturb{Fractal}(...)
   // Default: 1.0
-  void SetGradientPerturbAmp(FN_DECIMAL gradientPerturbAmp) { m_gradientPerturbAmp = gradientPerturbAmp; }
+  void SetGradientPerturbAmp(T gradientPerturbAmp) { m_gradientPerturbAmp = gradientPerturbAmp; }
 
   // Returns the maximum warp distance from original location when using GradientPerturb{Fractal}(...)
-  FN_DECIMAL GetGradientPerturbAmp() const { return m_gradientPerturbAmp; }
+  T GetGradientPerturbAmp() const { return m_gradientPerturbAmp; }
 
   //2D
-  FN_DECIMAL GetValue(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetValueFractal(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetValue(T x, T y) const;
+  T GetValueFractal(T x, T y) const;
 
-  FN_DECIMAL GetPerlin(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetPerlinFractal(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetPerlin(T x, T y) const;
+  T GetPerlinFractal(T x, T y) const;
 
-  FN_DECIMAL GetSimplex(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetSimplexFractal(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetSimplex(T x, T y) const;
+  T GetSimplexFractal(T x, T y) const;
 
-  FN_DECIMAL GetCellular(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetCellularFractal(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetCellular(T x, T y) const;
+  T GetCellularFractal(T x, T y) const;
 
-  FN_DECIMAL GetWhiteNoise(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetWhiteNoiseInt(int x, int y) const;
+  T GetWhiteNoise(T x, T y) const;
+  T GetWhiteNoiseInt(int x, int y) const;
 
-  FN_DECIMAL GetCubic(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL GetCubicFractal(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetCubic(T x, T y) const;
+  T GetCubicFractal(T x, T y) const;
 
-  FN_DECIMAL GetNoise(FN_DECIMAL x, FN_DECIMAL y) const;
+  T GetNoise(T x, T y) const;
 
-  void GradientPerturb(FN_DECIMAL& x, FN_DECIMAL& y) const;
-  void GradientPerturbFractal(FN_DECIMAL& x, FN_DECIMAL& y) const;
+  void GradientPerturb(T& x, T& y) const;
+  void GradientPerturbFractal(T& x, T& y) const;
 
   //3D
-  FN_DECIMAL GetValue(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetValueFractal(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  T GetValue(T x, T y, T z) const;
+  T GetValueFractal(T x, T y, T z) const;
+
+  T GetPerlin(T x, T y, T z) const;
+  T GetPerlinFractal(T x, T y, T z) const;
 
-  FN_DECIMAL GetPerlin(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetPerlinFractal(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  T GetSimplex(T x, T y, T z) const;
+  T GetSimplexFractal(T x, T y, T z) const;
 
-  FN_DECIMAL GetSimplex(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetSimplexFractal(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  T GetCellular(T x, T y, T z) const;
+  T GetCellularFractal(T x, T y, T z) const;
 
-  FN_DECIMAL GetCellular(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetCellularFractal(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  T GetWhiteNoise(T x, T y, T z) const;
+  T GetWhiteNoiseInt(int x, int y, int z) const;
 
-  FN_DECIMAL GetWhiteNoise(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetWhiteNoiseInt(int x, int y, int z) const;
+  T GetCubic(T x, T y, T z) const;
+  T GetCubicFractal(T x, T y, T z) const;
 
-  FN_DECIMAL GetCubic(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL GetCubicFractal(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  T GetNoise(T x, T y, T z) const;
 
-  FN_DECIMAL GetNoise(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
+  void GradientPerturb(T& x, T& y, T& z) const;
+  void GradientPerturbFractal(T& x, T& y, T& z) const;
 
-  void GradientPerturb(FN_DECIMAL& x, FN_DECIMAL& y, FN_DECIMAL& z) const;
-  void GradientPerturbFractal(FN_DECIMAL& x, FN_DECIMAL& y, FN_DECIMAL& z) const;
+  // Perturbs n 2D or 3D coordinates in place, resolving the interpolation
+  // once for the whole batch
+  void GradientPerturbBatch(int dims, T* const* coords, int n, bool fractal) const;
 
   //4D
-  FN_DECIMAL GetSimplex(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL w) const;
+  T GetSimplex(T x, T y, T z, T w) const;
+
+  T GetWhiteNoise(T x, T y, T z, T w) const;
+  T GetWhiteNoiseInt(int x, int y, int z, int w) const;
+
+  //Derivatives
+  // Noise along with its partial derivatives with respect to each coordinate,
+  // which are written to deriv. Available for Value, Perlin, Simplex and Cubic
+  // noise, other noise types give 0 for both the noise and the derivatives
+  T GetNoiseDeriv(T x, T y, T* deriv) const;
+  T GetNoiseDeriv(T x, T y, T z, T* deriv) const;
 
-  FN_DECIMAL GetWhiteNoise(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL w) const;
-  FN_DECIMAL GetWhiteNoiseInt(int x, int y, int z, int w) const;
+  //Batch
+  // Evaluates n points at once using SIMD instructions (see FastNoiseSIMD.cpp).
+  // coords holds one array of coordinates per dimension (2 to 4 for simplex, 2
+  // or 3 otherwise). Results match the single point methods to within 1e-12
+  // (1e-6 for float)
+  void GetValueBatch(int dims, const T* const* coords, T* out, int n) const;
+  void GetValueFractalBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  void GetPerlinBatch(int dims, const T* const* coords, T* out, int n) const;
+  void GetPerlinFractalBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  void GetSimplexBatch(int dims, const T* const* coords, T* out, int n) const;
+  void GetSimplexFractalBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  void GetCubicBatch(int dims, const T* const* coords, T* out, int n) const;
+  void GetCubicFractalBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  void GetCellularBatch(int dims, const T* const* coords, T* out, int n) const;
+  void GetCellularFractalBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  // Evaluates n points with the noise type set by SetNoiseType()
+  void GetNoiseBatch(int dims, const T* const* coords, T* out, int n) const;
+
+  // Evaluates a fractal noise type a few octaves at a time. Adds octaves
+  // [first, last) at n points in 2 or 3 dimensions to the running sums in
+  // `sum`, which start out as 0. `weight` holds the weights RigidMulti carries
+  // between octaves, starting out as 1, and can be null for the other fractal
+  // types. Other noise types leave the sums untouched
+  void GetFractalOctavesBatch(int dims, const T* const* coords, T* sum, T* weight, int n, int first, int last) const;
+
+  // Turns the sums of GetFractalOctavesBatch() into noise. With all octaves
+  // added this is identical to GetNoiseBatch()
+  void FinishFractalBatch(const T* sum, T* out, int n) const;
 
 private:
+  template <typename U> friend class FastNoiseT;
+  template <typename U> friend class FastNoiseGrid;
+  typedef FastNoiseLUT<T> LUT;
+
   unsigned char m_perm[512];
   unsigned char m_perm12[512];
 
   int m_seed = 1337;
-  FN_DECIMAL m_frequency = FN_DECIMAL(0.01);
+  SeedMode m_seedMode = SeedLegacy;
+  T m_frequency = T(0.01);
   Interp m_interp = Quintic;
   NoiseType m_noiseType = Simplex;
 
   int m_octaves = 3;
-  FN_DECIMAL m_lacunarity = FN_DECIMAL(2);
-  std::vector<FN_DECIMAL> m_pSpectralWeights = {FN_DECIMAL(-1)};
-  FN_DECIMAL m_gain = FN_DECIMAL(0.5);
+  T m_lacunarity = T(2);
+  std::vector<T> m_pSpectralWeights = {T(-1)};
+  T m_gain = T(0.5);
   FractalType m_fractalType = FBM;
-  FN_DECIMAL m_fractalBounding;
+  T m_fractalBounding;
 
   CellularDistanceFunction m_cellularDistanceFunction = Euclidean;
   CellularReturnType m_cellularReturnType = CellValue;
-  FastNoise* m_cellularNoiseLookup = nullptr;
+  FastNoiseT* m_cellularNoiseLookup = nullptr;
   int m_cellularDistanceIndex0 = 0;
   int m_cellularDistanceIndex1 = 1;
-  FN_DECIMAL m_cellularJitter = FN_DECIMAL(0.45);
+  T m_cellularJitter = T(0.45);
 
-  FN_DECIMAL m_gradientPerturbAmp = FN_DECIMAL(1);
+  T m_gradientPerturbAmp = T(1);
 
   void CalculateFractalBounding();
   void CalculateSpectralGain();
+  void BatchSetup(FastNoiseBatchParams<T>& params) const;
+  T SingleOctave(unsigned char offset, int dims, T x, T y, T z) const;
 
   //2D
-  FN_DECIMAL SingleValueFractalFBM(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleValueFractalBillow(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleValueFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleValue(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-
-  FN_DECIMAL SinglePerlinFractalFBM(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SinglePerlinFractalBillow(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SinglePerlinFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SinglePerlin(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-
-  FN_DECIMAL SingleSimplexFractalFBM(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleSimplexFractalBillow(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleSimplexFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleSimplexFractalBlend(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleSimplex(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-
-  FN_DECIMAL SingleCubicFractalFBM(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCubicFractalBillow(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCubicFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCubic(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-
-  FN_DECIMAL SingleCellularBase(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCellular(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCellular2Edge(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCellularFractalFBM(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCellularFractalBillow(FN_DECIMAL x, FN_DECIMAL y) const;
-  FN_DECIMAL SingleCellularFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y) const;
-
-  void SingleGradientPerturb(unsigned char offset, FN_DECIMAL warpAmp, FN_DECIMAL frequency, FN_DECIMAL& x, FN_DECIMAL& y) const;
+  T SingleValueFractalFBM(T x, T y) const;
+  T SingleValueFractalBillow(T x, T y) const;
+  T SingleValueFractalRigidMulti(T x, T y) const;
+  T SingleValue(unsigned char offset, T x, T y) const;
+
+  T SinglePerlinFractalFBM(T x, T y) const;
+  T SinglePerlinFractalBillow(T x, T y) const;
+  T SinglePerlinFractalRigidMulti(T x, T y) const;
+  T SinglePerlin(unsigned char offset, T x, T y) const;
+
+  T SingleSimplexFractalFBM(T x, T y) const;
+  T SingleSimplexFractalBillow(T x, T y) const;
+  T SingleSimplexFractalRigidMulti(T x, T y) const;
+  T SingleSimplexFractalBlend(T x, T y) const;
+  T SingleSimplex(unsigned char offset, T x, T y) const;
+
+  T SingleCubicFractalFBM(T x, T y) const;
+  T SingleCubicFractalBillow(T x, T y) const;
+  T SingleCubicFractalRigidMulti(T x, T y) const;
+  T SingleCubic(unsigned char offset, T x, T y) const;
+
+  T SingleCellularBase(unsigned char offset, T x, T y) const;
+  T SingleCellular(unsigned char offset, T x, T y) const;
+  T SingleCellular2Edge(unsigned char offset, T x, T y) const;
+  T SingleCellularFractalFBM(T x, T y) const;
+  T SingleCellularFractalBillow(T x, T y) const;
+  T SingleCellularFractalRigidMulti(T x, T y) const;
+
+  template <Interp I>
+  void SingleGradientPerturb(unsigned char offset, T warpAmp, T frequency, T& x, T& y) const;
 
   //3D
-  FN_DECIMAL SingleValueFractalFBM(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleValueFractalBillow(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleValueFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleValue(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-
-  FN_DECIMAL SinglePerlinFractalFBM(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SinglePerlinFractalBillow(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SinglePerlinFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SinglePerlin(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-
-  FN_DECIMAL SingleSimplexFractalFBM(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleSimplexFractalBillow(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleSimplexFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleSimplex(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-
-  FN_DECIMAL SingleCubicFractalFBM(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCubicFractalBillow(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCubicFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCubic(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-
-  FN_DECIMAL SingleCellularBase(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCellular(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCellular2Edge(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCellularFractalFBM(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCellularFractalBillow(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-  FN_DECIMAL SingleCellularFractalRigidMulti(FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) const;
-
-  void SingleGradientPerturb(unsigned char offset, FN_DECIMAL warpAmp, FN_DECIMAL frequency, FN_DECIMAL& x, FN_DECIMAL& y, FN_DECIMAL& z) const;
+  T SingleValueFractalFBM(T x, T y, T z) const;
+  T SingleValueFractalBillow(T x, T y, T z) const;
+  T SingleValueFractalRigidMulti(T x, T y, T z) const;
+  T SingleValue(unsigned char offset, T x, T y, T z) const;
+
+  T SinglePerlinFractalFBM(T x, T y, T z) const;
+  T SinglePerlinFractalBillow(T x, T y, T z) const;
+  T SinglePerlinFractalRigidMulti(T x, T y, T z) const;
+  T SinglePerlin(unsigned char offset, T x, T y, T z) const;
+
+  T SingleSimplexFractalFBM(T x, T y, T z) const;
+  T SingleSimplexFractalBillow(T x, T y, T z) const;
+  T SingleSimplexFractalRigidMulti(T x, T y, T z) const;
+  T SingleSimplex(unsigned char offset, T x, T y, T z) const;
+
+  T SingleCubicFractalFBM(T x, T y, T z) const;
+  T SingleCubicFractalBillow(T x, T y, T z) const;
+  T SingleCubicFractalRigidMulti(T x, T y, T z) const;
+  T SingleCubic(unsigned char offset, T x, T y, T z) const;
+
+  T SingleCellularBase(unsigned char offset, T x, T y, T z) const;
+  T SingleCellular(unsigned char offset, T x, T y, T z) const;
+  T SingleCellular2Edge(unsigned char offset, T x, T y, T z) const;
+  T SingleCellularFractalFBM(T x, T y, T z) const;
+  T SingleCellularFractalBillow(T x, T y, T z) const;
+  T SingleCellularFractalRigidMulti(T x, T y, T z) const;
+
+  template <Interp I>
+  void SingleGradientPerturb(unsigned char offset, T warpAmp, T frequency, T& x, T& y, T& z) const;
+  template <Interp I>
+  void GradientPerturbBatch(int dims, T* const* coords, int n, bool fractal) const;
 
   //4D
-  FN_DECIMAL SingleSimplex(unsigned char offset, FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL w) const;
+  T SingleSimplex(unsigned char offset, T x, T y, T z, T w) const;
+
+  //Derivatives
+  T SingleValueDeriv(unsigned char offset, T x, T y, T* deriv) const;
+  T SinglePerlinDeriv(unsigned char offset, T x, T y, T* deriv) const;
+  T SingleSimplexDeriv(unsigned char offset, T x, T y, T* deriv) const;
+  T SingleCubicDeriv(unsigned char offset, T x, T y, T* deriv) const;
+  T SingleValueDeriv(unsigned char offset, T x, T y, T z, T* deriv) const;
+  T SinglePerlinDeriv(unsigned char offset, T x, T y, T z, T* deriv) const;
+  T SingleSimplexDeriv(unsigned char offset, T x, T y, T z, T* deriv) const;
+  T SingleCubicDeriv(unsigned char offset, T x, T y, T z, T* deriv) const;
 
   inline unsigned char Index2D_12(unsigned char offset, int x, int y) const;
   inline unsigned char Index3D_12(unsigned char offset, int x, int y, int z) const;
@@ -316,10 +428,16 @@ private:
   inline unsigned char Index3D_256(unsigned char offset, int x, int y, int z) const;
   inline unsigned char Index4D_256(unsigned char offset, int x, int y, int z, int w) const;
 
-  inline FN_DECIMAL ValCoord2DFast(unsigned char offset, int x, int y) const;
-  inline FN_DECIMAL ValCoord3DFast(unsigned char offset, int x, int y, int z) const;
-  inline FN_DECIMAL GradCoord2D(unsigned char offset, int x, int y, FN_DECIMAL xd, FN_DECIMAL yd) const;
-  inline FN_DECIMAL GradCoord3D(unsigned char offset, int x, int y, int z, FN_DECIMAL xd, FN_DECIMAL yd, FN_DECIMAL zd) const;
-  inline FN_DECIMAL GradCoord4D(unsigned char offset, int x, int y, int z, int w, FN_DECIMAL xd, FN_DECIMAL yd, FN_DECIMAL zd, FN_DECIMAL wd) const;
+  inline T ValCoord2DFast(unsigned char offset, int x, int y) const;
+  inline T ValCoord3DFast(unsigned char offset, int x, int y, int z) const;
+  inline T GradCoord2D(unsigned char offset, int x, int y, T xd, T yd) const;
+  inline T GradCoord3D(unsigned char offset, int x, int y, int z, T xd, T yd, T zd) const;
+  inline T GradCoord4D(unsigned char offset, int x, int y, int z, int w, T xd, T yd, T zd, T wd) const;
 };
+
+extern template class FastNoiseT<float>;
+extern template class FastNoiseT<double>;
+
+typedef FastNoiseT<double> FastNoise;
+
 #endif
@@ -0,0 +1,140 @@
+// FastNoiseDual.h
+//
+// Dual numbers for forward mode automatic differentiation of the noise
+// engine. A FastNoiseDual holds a value together with its partial derivatives
+// with respect to up to four inputs, and the arithmetic and math functions
+// used by FastNoise.cpp propagate these by the chain rule. Instantiating
+// FastNoiseT with it gives the exact gradient of every noise type, including
+// fractals and perturbation, alongside the value which is computed exactly
+// as in double precision. Integer conversions (lattice lookups) and
+// comparisons only look at the value.
+//
+// The engine is instantiated for FastNoiseDual at the end of FastNoise.cpp.
+// Only the single point methods are available, not the batch methods.
+
+#ifndef FASTNOISE_DUAL_H
+#define FASTNOISE_DUAL_H
+
+#include <math.h>
+#include "FastNoise.h"
+
+struct FastNoiseDual
+{
+  static const int N = 4;
+
+  double v;
+  double d[N];
+
+  FastNoiseDual(double value = 0) : v(value), d{0, 0, 0, 0} {}
+
+  // An input variable: derivative 1 with respect to itself
+  static FastNoiseDual Variable(double value, int index)
+  {
+    FastNoiseDual x(value);
+    x.d[index] = 1;
+    return x;
+  }
+
+  explicit operator int() const { return (int)v; }
+
+  FastNoiseDual operator-() const
+  {
+    FastNoiseDual r(-v);
+    for (int i = 0; i < N; i++) r.d[i] = -d[i];
+    return r;
+  }
+
+  FastNoiseDual& operator+=(const FastNoiseDual& o)
+  {
+    v += o.v;
+    for (int i = 0; i < N; i++) d[i] += o.d[i];
+    return *this;
+  }
+  FastNoiseDual& operator-=(const FastNoiseDual& o)
+  {
+    v -= o.v;
+    for (int i = 0; i < N; i++) d[i] -= o.d[i];
+    return *this;
+  }
+  FastNoiseDual& operator*=(const FastNoiseDual& o)
+  {
+    for (int i = 0; i < N; i++) d[i] = d[i] * o.v + v * o.d[i];
+    v *= o.v;
+    return *this;
+  }
+  FastNoiseDual& operator/=(const FastNoiseDual& o)
+  {
+    for (int i = 0; i < N; i++) d[i] = (d[i] * o.v - v * o.d[i]) / (o.v * o.v);
+    v /= o.v;
+    return *this;
+  }
+  FastNoiseDual& operator+=(double o) { v += o; return *this; }
+  FastNoiseDual& operator-=(double o) { v -= o; return *this; }
+  FastNoiseDual& operator*=(double o)
+  {
+    v *= o;
+    for (int i = 0; i < N; i++) d[i] *= o;
+    return *this;
+  }
+  FastNoiseDual& operator/=(double o)
+  {
+    v /= o;
+    for (int i = 0; i < N; i++) d[i] /= o;
+    return *this;
+  }
+};
+
+inline FastNoiseDual operator+(FastNoiseDual a, const FastNoiseDual& b) { return a += b; }
+inline FastNoiseDual operator-(FastNoiseDual a, const FastNoiseDual& b) { return a -= b; }
+inline FastNoiseDual operator*(FastNoiseDual a, const FastNoiseDual& b) { return a *= b; }
+inline FastNoiseDual operator/(FastNoiseDual a, const FastNoiseDual& b) { return a /= b; }
+
+inline FastNoiseDual operator+(FastNoiseDual a, double b) { return a += b; }
+inline FastNoiseDual operator-(FastNoiseDual a, double b) { return a -= b; }
+inline FastNoiseDual operator*(FastNoiseDual a, double b) { return a *= b; }
+inline FastNoiseDual operator/(FastNoiseDual a, double b) { return a /= b; }
+
+inline FastNoiseDual operator+(double a, FastNoiseDual b) { return b += a; }
+inline FastNoiseDual operator-(double a, const FastNoiseDual& b) { return -b + a; }
+inline FastNoiseDual operator*(double a, FastNoiseDual b) { return b *= a; }
+inline FastNoiseDual operator/(double a, const FastNoiseDual& b) { return FastNoiseDual(a) / b; }
+
+inline bool operator<(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v < b.v; }
+inline bool operator>(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v > b.v; }
+inline bool operator<=(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v <= b.v; }
+inline bool operator>=(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v >= b.v; }
+inline bool operator<(const FastNoiseDual& a, double b) { return a.v < b; }
+inline bool operator>(const FastNoiseDual& a, double b) { return a.v > b; }
+inline bool operator<=(const FastNoiseDual& a, double b) { return a.v <= b; }
+inline bool operator>=(const FastNoiseDual& a, double b) { return a.v >= b; }
+inline bool operator<(double a, const FastNoiseDual& b) { return a < b.v; }
+inline bool operator>(double a, const FastNoiseDual& b) { return a > b.v; }
+inline bool operator<=(double a, const FastNoiseDual& b) { return a <= b.v; }
+inline bool operator>=(double a, const FastNoiseDual& b) { return a >= b.v; }
+
+inline FastNoiseDual fabs(const FastNoiseDual& a) { return a.v < 0 ? -a : a; }
+// Like their double counterparts these return the other argument if one is NaN
+inline FastNoiseDual fmin(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v != a.v || b.v < a.v ? b : a; }
+inline FastNoiseDual fmax(const FastNoiseDual& a, const FastNoiseDual& b) { return a.v != a.v || b.v > a.v ? b : a; }
+
+inline FastNoiseDual sqrt(const FastNoiseDual& a)
+{
+  FastNoiseDual r(sqrt(a.v));
+  for (int i = 0; i < FastNoiseDual::N; i++) r.d[i] = a.d[i] / (2 * r.v);
+  return r;
+}
+
+inline FastNoiseDual pow(const FastNoiseDual& a, const FastNoiseDual& b)
+{
+  FastNoiseDual r(pow(a.v, b.v));
+  for (int i = 0; i < FastNoiseDual::N; i++)
+  {
+    r.d[i] = b.v * pow(a.v, b.v - 1) * a.d[i];
+    if (b.d[i] != 0) r.d[i] += r.v * log(a.v) * b.d[i];
+  }
+  return r;
+}
+
+extern template class FastNoiseT<FastNoiseDual>;
+
+#endif
@@ -0,0 +1,484 @@
+// FastNoiseGrid.cpp
+//
+// See FastNoiseGrid.h. The arithmetic mirrors SingleValue(), SinglePerlin(),
+// SingleCubic() and the Single*Fractal*() methods in FastNoise.cpp operation
+// for operation; only the hashing and interpolation weights are hoisted out of
+// the pixel loop.
+
+#include "FastNoiseGrid.h"
+#include "FastNoiseLUT.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+template <typename T>
+static int GridFloor(T f) { return (f >= 0 ? (int)f : (int)f - 1); }
+template <typename T>
+static T GridLerp(T a, T b, T t) { return a + t * (b - a); }
+template <typename T>
+static T GridCubicLerp(T a, T b, T c, T d, T t)
+{
+  T p = (d - c) - (a - b);
+  return t * t * t * p + t * t * ((a - b) - p) + t * (c - a) + b;
+}
+
+template <typename T>
+bool FastNoiseGrid<T>::Supports(const FastNoiseT<T>& noise)
+{
+  switch (noise.GetNoiseType())
+  {
+  case FastNoiseBase::Value:
+  case FastNoiseBase::ValueFractal:
+  case FastNoiseBase::Perlin:
+  case FastNoiseBase::PerlinFractal:
+  case FastNoiseBase::Cubic:
+  case FastNoiseBase::CubicFractal:
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <typename T>
+FastNoiseGrid<T>::FastNoiseGrid(const FastNoiseT<T>& noise, int width, int x0) :
+  m_noise(noise),
+  m_single(width),
+  m_amp(width)
+{
+  switch (noise.m_noiseType)
+  {
+  case FastNoiseBase::Perlin:
+  case FastNoiseBase::PerlinFractal:
+    m_kind = PerlinKind;
+    break;
+  case FastNoiseBase::Cubic:
+  case FastNoiseBase::CubicFractal:
+    m_kind = CubicKind;
+    break;
+  default:
+    m_kind = ValueKind;
+  }
+  m_fractal = noise.m_noiseType == FastNoiseBase::ValueFractal ||
+    noise.m_noiseType == FastNoiseBase::PerlinFractal ||
+    noise.m_noiseType == FastNoiseBase::CubicFractal;
+
+  int n_octaves = m_fractal ? noise.m_octaves : 1;
+  m_octaves.resize(n_octaves);
+
+  std::vector<T> x(width);
+  for (int j = 0; j < width; ++j)
+  {
+    x[j] = (T) (x0 + j) * noise.m_frequency;
+  }
+
+  for (int i = 0; i < n_octaves; ++i)
+  {
+    Octave& octave = m_octaves[i];
+    if (i > 0)
+    {
+      for (int j = 0; j < width; ++j)
+      {
+        x[j] *= noise.m_lacunarity;
+      }
+    }
+    octave.offset = m_fractal ? noise.m_perm[i] : 0;
+    octave.cell.resize(width);
+    octave.xd.resize(width);
+    octave.xs.resize(width);
+    octave.line_dims = 0;
+
+    for (int j = 0; j < width; ++j)
+    {
+      int x0 = GridFloor(x[j]);
+      if (octave.lattice.empty() || octave.lattice.back() != x0)
+      {
+        octave.lattice.push_back(x0);
+      }
+      octave.cell[j] = octave.lattice.size() - 1;
+      octave.xd[j] = x[j] - (T)x0;
+      octave.xs[j] = m_kind == CubicKind ? octave.xd[j] : InterpWeight(octave.xd[j]);
+    }
+  }
+}
+
+template <typename T>
+T FastNoiseGrid<T>::InterpWeight(T t) const
+{
+  switch (m_noise.m_interp)
+  {
+  case FastNoiseBase::Hermite:
+    return t*t*(3 - 2 * t);
+  case FastNoiseBase::Quintic:
+    return t*t*t*(t*(t * 6 - 15) + 10);
+  default:
+    return t;
+  }
+}
+
+// Corners are stored per lattice line (y and z lattice coordinate), tap (x
+// lattice coordinate relative to the cell) and component (the value, or the
+// gradient vector for perlin noise), each holding one entry per cell
+template <typename T>
+void FastNoiseGrid<T>::FillCorners(Octave& octave, int dims, int y0, int z0, int cell_begin, int cell_end)
+{
+  const unsigned char* perm = m_noise.m_perm;
+  const unsigned char* perm12 = m_noise.m_perm12;
+  int taps = Taps();
+  int lines = dims == 2 ? taps : taps * taps;
+  int comps = m_kind == PerlinKind ? dims : 1;
+  int n_cell = octave.lattice.size();
+  int x_shift = m_kind == CubicKind ? -1 : 0;
+  octave.corner.resize((size_t) lines * taps * comps * n_cell);
+
+  for (int l = 0; l < lines; ++l)
+  {
+    int yl = y0 + l % taps;
+    int zl = z0 + l / taps;
+    int hash = dims == 2 ? perm[(yl & 0xff) + octave.offset] : perm[(yl & 0xff) + perm[(zl & 0xff) + octave.offset]];
+
+    for (int t = 0; t < taps; ++t)
+    {
+      T* corner = octave.corner.data() + (size_t) (l * taps + t) * comps * n_cell;
+      if (m_kind == PerlinKind)
+      {
+        T* gx = corner;
+        T* gy = corner + n_cell;
+        T* gz = corner + 2 * n_cell;
+        for (int u = cell_begin; u < cell_end; ++u)
+        {
+          unsigned char lutPos = perm12[((octave.lattice[u] + x_shift + t) & 0xff) + hash];
+          gx[u] = FastNoiseLUT<T>::GRAD_X[lutPos];
+          gy[u] = FastNoiseLUT<T>::GRAD_Y[lutPos];
+          if (dims == 3) gz[u] = FastNoiseLUT<T>::GRAD_Z[lutPos];
+        }
+      }
+      else
+      {
+        for (int u = cell_begin; u < cell_end; ++u)
+        {
+          corner[u] = FastNoiseLUT<T>::VAL_LUT[perm[((octave.lattice[u] + x_shift + t) & 0xff) + hash]];
+        }
+      }
+    }
+  }
+
+  octave.line_y = y0;
+  octave.line_z = z0;
+  octave.line_dims = dims;
+  octave.cell_begin = cell_begin;
+  octave.cell_end = cell_end;
+}
+
+template <typename T>
+void FastNoiseGrid<T>::Single(Octave& octave, int dims, T y, T z, int begin, int n, T* out)
+{
+  int y0 = GridFloor(y);
+  int z0 = dims == 3 ? GridFloor(z) : 0;
+  T yd0 = y - (T)y0;
+  T zd0 = z - (T)z0;
+  int shift = m_kind == CubicKind ? -1 : 0;
+  int cell_begin = octave.cell[begin];
+  int cell_end = octave.cell[begin + n - 1] + 1;
+  if (octave.line_dims != dims || octave.line_y != y0 + shift || octave.line_z != z0 + shift ||
+      cell_begin < octave.cell_begin || cell_end > octave.cell_end)
+  {
+    FillCorners(octave, dims, y0 + shift, z0 + shift, cell_begin, cell_end);
+  }
+
+  int taps = Taps();
+  int comps = m_kind == PerlinKind ? dims : 1;
+  size_t n_cell = octave.lattice.size();
+  const T* corner = octave.corner.data();
+  const int* cell = octave.cell.data() + begin;
+  const T* xd = octave.xd.data() + begin;
+  const T* xs = octave.xs.data() + begin;
+  // Pointer to the first component of a line and tap
+  #define CORNER(l, t) (corner + ((l) * taps + (t)) * comps * n_cell)
+
+  if (m_kind == ValueKind)
+  {
+    T ys = InterpWeight(yd0);
+    if (dims == 2)
+    {
+      const T* c00 = CORNER(0, 0); const T* c10 = CORNER(0, 1);
+      const T* c01 = CORNER(1, 0); const T* c11 = CORNER(1, 1);
+      for (int j = 0; j < n; ++j)
+      {
+        int u = cell[j];
+        T xf0 = GridLerp(c00[u], c10[u], xs[j]);
+        T xf1 = GridLerp(c01[u], c11[u], xs[j]);
+        out[j] = GridLerp(xf0, xf1, ys);
+      }
+    }
+    else
+    {
+      T zs = InterpWeight(zd0);
+      const T* c000 = CORNER(0, 0); const T* c100 = CORNER(0, 1);
+      const T* c010 = CORNER(1, 0); const T* c110 = CORNER(1, 1);
+      const T* c001 = CORNER(2, 0); const T* c101 = CORNER(2, 1);
+      const T* c011 = CORNER(3, 0); const T* c111 = CORNER(3, 1);
+      for (int j = 0; j < n; ++j)
+      {
+        int u = cell[j];
+        T xf00 = GridLerp(c000[u], c100[u], xs[j]);
+        T xf10 = GridLerp(c010[u], c110[u], xs[j]);
+        T xf01 = GridLerp(c001[u], c101[u], xs[j]);
+        T xf11 = GridLerp(c011[u], c111[u], xs[j]);
+
+        T yf0 = GridLerp(xf00, xf10, ys);
+        T yf1 = GridLerp(xf01, xf11, ys);
+
+        out[j] = GridLerp(yf0, yf1, zs);
+      }
+    }
+  }
+  else if (m_kind == PerlinKind)
+  {
+    T ys = InterpWeight(yd0);
+    T yd1 = yd0 - 1;
+    if (dims == 2)
+    {
+      const T* c00 = CORNER(0, 0); const T* c10 = CORNER(0, 1);
+      const T* c01 = CORNER(1, 0); const T* c11 = CORNER(1, 1);
+      for (int j = 0; j < n; ++j)
+      {
+        size_t u = cell[j];
+        T xd0 = xd[j];
+        T xd1 = xd0 - 1;
+        T xf0 = GridLerp(xd0*c00[u] + yd0*c00[u + n_cell], xd1*c10[u] + yd0*c10[u + n_cell], xs[j]);
+        T xf1 = GridLerp(xd0*c01[u] + yd1*c01[u + n_cell], xd1*c11[u] + yd1*c11[u + n_cell], xs[j]);
+        out[j] = GridLerp(xf0, xf1, ys);
+      }
+    }
+    else
+    {
+      T zs = InterpWeight(zd0);
+      T zd1 = zd0 - 1;
+      size_t n2 = 2 * n_cell;
+      const T* c000 = CORNER(0, 0); const T* c100 = CORNER(0, 1);
+      const T* c010 = CORNER(1, 0); const T* c110 = CORNER(1, 1);
+      const T* c001 = CORNER(2, 0); const T* c101 = CORNER(2, 1);
+      const T* c011 = CORNER(3, 0); const T* c111 = CORNER(3, 1);
+      for (int j = 0; j < n; ++j)
+      {
+        size_t u = cell[j];
+        T xd0 = xd[j];
+        T xd1 = xd0 - 1;
+        T xf00 = GridLerp(xd0*c000[u] + yd0*c000[u + n_cell] + zd0*c000[u + n2], xd1*c100[u] + yd0*c100[u + n_cell] + zd0*c100[u + n2], xs[j]);
+        T xf10 = GridLerp(xd0*c010[u] + yd1*c010[u + n_cell] + zd0*c010[u + n2], xd1*c110[u] + yd1*c110[u + n_cell] + zd0*c110[u + n2], xs[j]);
+        T xf01 = GridLerp(xd0*c001[u] + yd0*c001[u + n_cell] + zd1*c001[u + n2], xd1*c101[u] + yd0*c101[u + n_cell] + zd1*c101[u + n2], xs[j]);
+        T xf11 = GridLerp(xd0*c011[u] + yd1*c011[u + n_cell] + zd1*c011[u + n2], xd1*c111[u] + yd1*c111[u + n_cell] + zd1*c111[u + n2], xs[j]);
+
+        T yf0 = GridLerp(xf00, xf10, ys);
+        T yf1 = GridLerp(xf01, xf11, ys);
+
+        out[j] = GridLerp(yf0, yf1, zs);
+      }
+    }
+  }
+  else
+  {
+    T ys = yd0;
+    if (dims == 2)
+    {
+      const T* c[4][4];
+      for (int l = 0; l < 4; ++l)
+        for (int t = 0; t < 4; ++t)
+          c[l][t] = CORNER(l, t);
+      for (int j = 0; j < n; ++j)
+      {
+        int u = cell[j];
+        T s = xs[j];
+        out[j] = GridCubicLerp(
+          GridCubicLerp(c[0][0][u], c[0][1][u], c[0][2][u], c[0][3][u], s),
+          GridCubicLerp(c[1][0][u], c[1][1][u], c[1][2][u], c[1][3][u], s),
+          GridCubicLerp(c[2][0][u], c[2][1][u], c[2][2][u], c[2][3][u], s),
+          GridCubicLerp(c[3][0][u], c[3][1][u], c[3][2][u], c[3][3][u], s),
+          ys) * FastNoiseLUT<T>::CUBIC_2D_BOUNDING;
+      }
+    }
+    else
+    {
+      T zs = zd0;
+      const T* c[16][4];
+      for (int l = 0; l < 16; ++l)
+        for (int t = 0; t < 4; ++t)
+          c[l][t] = CORNER(l, t);
+      T yl[4];
+      for (int j = 0; j < n; ++j)
+      {
+        int u = cell[j];
+        T s = xs[j];
+        for (int lz = 0; lz < 4; ++lz)
+        {
+          const T* const* r0 = c[lz * 4];
+          const T* const* r1 = c[lz * 4 + 1];
+          const T* const* r2 = c[lz * 4 + 2];
+          const T* const* r3 = c[lz * 4 + 3];
+          yl[lz] = GridCubicLerp(
+            GridCubicLerp(r0[0][u], r0[1][u], r0[2][u], r0[3][u], s),
+            GridCubicLerp(r1[0][u], r1[1][u], r1[2][u], r1[3][u], s),
+            GridCubicLerp(r2[0][u], r2[1][u], r2[2][u], r2[3][u], s),
+            GridCubicLerp(r3[0][u], r3[1][u], r3[2][u], r3[3][u], s),
+            ys);
+        }
+        out[j] = GridCubicLerp(yl[0], yl[1], yl[2], yl[3], zs) * FastNoiseLUT<T>::CUBIC_3D_BOUNDING;
+      }
+    }
+  }
+
+  #undef CORNER
+}
+
+// Octaves are accumulated one at a time over the whole row, following the
+// per point order of operations of the fractal methods
+template <typename T>
+void FastNoiseGrid<T>::Accumulate(int dims, T y, T z, int begin, int n, T* out)
+{
+  const FastNoiseT<T>& noise = m_noise;
+  y *= noise.m_frequency;
+  z *= noise.m_frequency;
+
+  if (!m_fractal)
+  {
+    Single(m_octaves[0], dims, y, z, begin, n, out);
+    return;
+  }
+
+  T amp = 1;
+  T* single = m_single.data();
+  T* pixel_amp = m_amp.data();
+
+  for (size_t i = 0; i < m_octaves.size(); ++i)
+  {
+    if (i > 0)
+    {
+      y *= noise.m_lacunarity;
+      z *= noise.m_lacunarity;
+      amp *= noise.m_gain;
+    }
+    Single(m_octaves[i], dims, y, z, begin, n, single);
+
+    switch (noise.m_fractalType)
+    {
+    case FastNoiseBase::FBM:
+      if (i == 0)
+      {
+        for (int j = 0; j < n; ++j) out[j] = single[j];
+      }
+      else
+      {
+        for (int j = 0; j < n; ++j) out[j] += single[j] * amp;
+      }
+      break;
+    case FastNoiseBase::Billow:
+      if (i == 0)
+      {
+        for (int j = 0; j < n; ++j) out[j] = fabs(single[j]) * 2 - 1;
+      }
+      else
+      {
+        for (int j = 0; j < n; ++j) out[j] += (fabs(single[j]) * 2 - 1) * amp;
+      }
+      break;
+    case FastNoiseBase::RigidMulti:
+      for (int j = 0; j < n; ++j)
+      {
+        T sig = 1 - fabs(single[j]);
+        sig *= sig;
+        if (i == 0)
+        {
+          out[j] = sig * noise.m_pSpectralWeights[0];
+        }
+        else
+        {
+          sig *= pixel_amp[j];
+          out[j] += (sig * noise.m_pSpectralWeights[i]);
+        }
+        T a = sig * noise.m_gain;
+        if (a > 1.0) {
+          a = 1.0;
+        }
+        if (a < 0.0) {
+          a = 0.0;
+        }
+        pixel_amp[j] = a;
+      }
+      break;
+    }
+  }
+
+  if (noise.m_fractalType == FastNoiseBase::RigidMulti)
+  {
+    for (int j = 0; j < n; ++j) out[j] = (out[j] * T(1.25)) - T(1.0);
+  }
+  else
+  {
+    for (int j = 0; j < n; ++j) out[j] *= noise.m_fractalBounding;
+  }
+}
+
+template <typename T>
+void FastNoiseGrid<T>::RowOctaves(T y, int begin, int n, T* sum, T* weight, int first, int last)
+{
+  const FastNoiseT<T>& noise = m_noise;
+  y *= noise.m_frequency;
+
+  T amp = 1;
+  T* single = m_single.data();
+  last = std::min(last, (int) m_octaves.size());
+
+  for (int i = 0; i < last; ++i)
+  {
+    if (i > 0)
+    {
+      y *= noise.m_lacunarity;
+      amp *= noise.m_gain;
+    }
+    if (i < first) continue;
+    Single(m_octaves[i], 2, y, 0, begin, n, single);
+
+    switch (noise.m_fractalType)
+    {
+    case FastNoiseBase::FBM:
+      for (int j = 0; j < n; ++j) sum[j] += single[j] * amp;
+      break;
+    case FastNoiseBase::Billow:
+      for (int j = 0; j < n; ++j) sum[j] += (fabs(single[j]) * 2 - 1) * amp;
+      break;
+    case FastNoiseBase::RigidMulti:
+      for (int j = 0; j < n; ++j)
+      {
+        T sig = 1 - fabs(single[j]);
+        sig *= sig;
+        sig *= weight[j];
+        T a = sig * noise.m_gain;
+        if (a > 1.0) {
+          a = 1.0;
+        }
+        if (a < 0.0) {
+          a = 0.0;
+        }
+        weight[j] = a;
+        sum[j] += (sig * noise.m_pSpectralWeights[i]);
+      }
+      break;
+    }
+  }
+}
+
+template <typename T>
+void FastNoiseGrid<T>::Row(T y, int begin, int n, T* out)
+{
+  Accumulate(2, y, 0, begin, n, out);
+}
+
+template <typename T>
+void FastNoiseGrid<T>::Row(T y, T z, int begin, int n, T* out)
+{
+  Accumulate(3, y, z, begin, n, out);
+}
+
+template class FastNoiseGrid<float>;
+template class FastNoiseGrid<double>;
@@ -0,0 +1,81 @@
+// FastNoiseGrid.h
+//
+// Lattice coherent evaluation of value, perlin and cubic noise (and their
+// fractals) over a regular grid. The x coordinates are the (offset) column
+// indices and are shared by every row, so the lattice cell, interpolation
+// weight and offset along x are derived once per octave when the grid is
+// created. Rows hash their lattice lines once and every run of pixels falling
+// inside the same lattice cell is filled from the cached corner values.
+// Corners are kept between rows and only recomputed when a row crosses into a
+// new lattice cell or asks for columns outside of those computed so far. Rows
+// can be evaluated in parts, as when a grid is generated in tiles.
+// Results are identical to GetNoise() on the same coordinates.
+//
+// A grid holds scratch memory for its rows so each thread must use its own.
+
+#ifndef FASTNOISE_GRID_H
+#define FASTNOISE_GRID_H
+
+#include <vector>
+#include "FastNoise.h"
+
+template <typename T>
+class FastNoiseGrid
+{
+public:
+  // The columns of the grid lie at x = x0, ..., x0 + width - 1
+  FastNoiseGrid(const FastNoiseT<T>& noise, int width, int x0 = 0);
+
+  // Whether the noise type of the generator can be evaluated on a grid
+  static bool Supports(const FastNoiseT<T>& noise);
+
+  // Writes the noise at columns begin, ..., begin + n - 1 of a row to out
+  void Row(T y, int begin, int n, T* out);
+  void Row(T y, T z, int begin, int n, T* out);
+
+  // Adds octaves [first, last) of a 2D fractal at columns begin, ...,
+  // begin + n - 1 of a row to the running sums and weights, as
+  // GetFractalOctavesBatch() does
+  void RowOctaves(T y, int begin, int n, T* sum, T* weight, int first, int last);
+
+private:
+  struct Octave
+  {
+    unsigned char offset;
+    // Per column: the lattice cell (as an index into lattice) and the
+    // distance from, and interpolation weight along, the lattice point
+    std::vector<int> cell;
+    std::vector<T> xd;
+    std::vector<T> xs;
+    // The x coordinate of each distinct lattice cell in column order
+    std::vector<int> lattice;
+    // Corner values per line, tap and cell along with the lattice line and
+    // range of cells they were computed for
+    std::vector<T> corner;
+    int line_y;
+    int line_z;
+    int line_dims;
+    int cell_begin;
+    int cell_end;
+  };
+
+  enum Kind { ValueKind, PerlinKind, CubicKind };
+
+  const FastNoiseT<T>& m_noise;
+  Kind m_kind;
+  bool m_fractal;
+  std::vector<Octave> m_octaves;
+  std::vector<T> m_single;
+  std::vector<T> m_amp;
+
+  int Taps() const { return m_kind == CubicKind ? 4 : 2; }
+  T InterpWeight(T t) const;
+  void FillCorners(Octave& octave, int dims, int y0, int z0, int cell_begin, int cell_end);
+  void Single(Octave& octave, int dims, T y, T z, int begin, int n, T* out);
+  void Accumulate(int dims, T y, T z, int begin, int n, T* out);
+};
+
+extern template class FastNoiseGrid<float>;
+extern template class FastNoiseGrid<double>;
+
+#endif
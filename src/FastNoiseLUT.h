@@ -0,0 +1,40 @@
+// FastNoiseLUT.h
+//
+// Lookup tables and constants defined in FastNoise.cpp that are shared with
+// the batch kernels in FastNoiseSIMD.cpp. They are instantiated once per
+// scalar type so the single precision engine never converts from double.
+
+#ifndef FASTNOISE_LUT_H
+#define FASTNOISE_LUT_H
+
+#include "FastNoise.h"
+
+template <typename T>
+struct FastNoiseLUT
+{
+  static const T GRAD_X[];
+  static const T GRAD_Y[];
+  static const T GRAD_Z[];
+  static const T GRAD_4D[];
+  static const T VAL_LUT[];
+  static const T CELL_2D_X[];
+  static const T CELL_2D_Y[];
+  static const T CELL_3D_X[];
+  static const T CELL_3D_Y[];
+  static const T CELL_3D_Z[];
+
+  static const T SQRT3;
+  static const T F2;
+  static const T G2;
+  static const T F3;
+  static const T G3;
+  static const T F4;
+  static const T G4;
+  static const T CUBIC_2D_BOUNDING;
+  static const T CUBIC_3D_BOUNDING;
+};
+
+extern template struct FastNoiseLUT<float>;
+extern template struct FastNoiseLUT<double>;
+
+#endif
@@ -0,0 +1,528 @@
+// FastNoiseSIMD.cpp
+//
+// Batch evaluation of FastNoise. The kernels in FastNoiseSIMD.inc are written
+// with GCC/Clang vector extensions and compiled once per instruction set, the
+// widest one supported by the CPU being picked at runtime. Compilers without
+// vector extensions fall back to calling the single point methods.
+//
+// The kernels perform the same floating point operations in the same order as
+// the scalar code and are compiled without fused multiply-adds, so results are
+// identical to the single point methods. The exception is platforms where the
+// compiler fuses multiply-adds in the scalar code (e.g. GCC on arm64), where
+// they differ by no more than 1e-12 (1e-6 in single precision).
+
+#include "FastNoise.h"
+#include "FastNoiseLUT.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+template <typename T>
+struct FastNoiseBatchParams
+{
+  const unsigned char* perm;
+  const unsigned char* perm12;
+  T frequency;
+  int octaves;
+  T lacunarity;
+  T gain;
+  T fractal_bounding;
+  const T* spectral_weights;
+  FastNoiseBase::FractalType fractal_type;
+  FastNoiseBase::Interp interp;
+  int seed;
+  FastNoiseBase::CellularDistanceFunction cellular_distance;
+  FastNoiseBase::CellularReturnType cellular_return;
+  int cellular_index0;
+  int cellular_index1;
+  T cellular_jitter;
+  const FastNoiseT<T>* cellular_lookup;
+  // Set by GetFractalOctavesBatch(): the fractal kernels add octaves
+  // [first_octave, octaves) to the sums in `out` instead of writing the noise,
+  // with the RigidMulti weights carried in `weights`
+  bool accumulate;
+  int first_octave;
+  T* weights;
+};
+
+template <typename T>
+struct BatchKernels
+{
+  typedef void (*Kernel)(const FastNoiseBatchParams<T>& p, int dims, bool fractal, const T* const* coords, T* out, int n);
+
+  Kernel simplex;
+  Kernel value;
+  Kernel perlin;
+  Kernel cubic;
+  Kernel cellular;
+};
+
+#define FN_CAT_(a, b) a##_##b
+#define FN_CAT(a, b) FN_CAT_(a, b)
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define FN_SIMD
+#if defined(__x86_64__) || defined(__i386__)
+#define FN_SIMD_X86
+// MinGW does not keep the stack aligned for spilled 256 bit registers
+#if !defined(_WIN32) || defined(__clang__)
+#define FN_SIMD_X86_WIDE
+#endif
+#endif
+#endif
+
+#if defined(FN_SIMD)
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#else
+#pragma GCC optimize("fp-contract=off")
+#endif
+#endif
+
+#if defined(FN_SIMD_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+#define SIMD_NS fn_sse2
+#define SIMD_BYTES 16
+#include "FastNoiseSIMD.inc"
+#undef SIMD_NS
+#undef SIMD_BYTES
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(FN_SIMD_X86_WIDE)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+#define SIMD_NS fn_avx2
+#define SIMD_BYTES 32
+#include "FastNoiseSIMD.inc"
+#undef SIMD_NS
+#undef SIMD_BYTES
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+#define SIMD_NS fn_avx512
+#define SIMD_BYTES 64
+#include "FastNoiseSIMD.inc"
+#undef SIMD_NS
+#undef SIMD_BYTES
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // FN_SIMD_X86_WIDE
+
+#elif defined(FN_SIMD)
+
+// Other architectures get the 128 bit kernels for the baseline instruction
+// set (e.g. NEON on arm64)
+#define SIMD_NS fn_generic
+#define SIMD_BYTES 16
+#include "FastNoiseSIMD.inc"
+#undef SIMD_NS
+#undef SIMD_BYTES
+
+#endif
+
+static FastNoiseBase::SIMDLevel DetectSIMDLevel()
+{
+#if defined(FN_SIMD_X86)
+  __builtin_cpu_init();
+#if defined(FN_SIMD_X86_WIDE)
+  if (__builtin_cpu_supports("avx512f")) return FastNoiseBase::SIMD512;
+  if (__builtin_cpu_supports("avx2")) return FastNoiseBase::SIMD256;
+#endif
+  if (__builtin_cpu_supports("sse2")) return FastNoiseBase::SIMD128;
+  return FastNoiseBase::SIMDScalar;
+#elif defined(FN_SIMD)
+  return FastNoiseBase::SIMD128;
+#else
+  return FastNoiseBase::SIMDScalar;
+#endif
+}
+
+static FastNoiseBase::SIMDLevel SupportedSIMDLevel()
+{
+  static const FastNoiseBase::SIMDLevel level = DetectSIMDLevel();
+  return level;
+}
+
+static std::atomic<int> s_simdLevel(-1);
+
+FastNoiseBase::SIMDLevel FastNoiseBase::GetSIMDLevel()
+{
+  int level = s_simdLevel.load();
+  return level < 0 ? SupportedSIMDLevel() : (SIMDLevel) level;
+}
+
+void FastNoiseBase::SetSIMDLevel(SIMDLevel level)
+{
+  s_simdLevel = std::min(level, SupportedSIMDLevel());
+}
+
+template <typename T>
+static const BatchKernels<T>* GetBatchKernels()
+{
+  switch (FastNoiseBase::GetSIMDLevel())
+  {
+#if defined(FN_SIMD_X86_WIDE)
+  case FastNoiseBase::SIMD512:
+    return fn_avx512::batch_kernels((T*) nullptr);
+  case FastNoiseBase::SIMD256:
+    return fn_avx2::batch_kernels((T*) nullptr);
+#endif
+#if defined(FN_SIMD_X86)
+  case FastNoiseBase::SIMD128:
+    return fn_sse2::batch_kernels((T*) nullptr);
+#elif defined(FN_SIMD)
+  case FastNoiseBase::SIMD128:
+    return fn_generic::batch_kernels((T*) nullptr);
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+template <typename T>
+void FastNoiseT<T>::BatchSetup(FastNoiseBatchParams<T>& params) const
+{
+  params.perm = m_perm;
+  params.perm12 = m_perm12;
+  params.frequency = m_frequency;
+  params.octaves = m_octaves;
+  params.lacunarity = m_lacunarity;
+  params.gain = m_gain;
+  params.fractal_bounding = m_fractalBounding;
+  params.spectral_weights = m_pSpectralWeights.data();
+  params.fractal_type = m_fractalType;
+  params.interp = m_interp;
+  params.seed = m_seed;
+  params.cellular_distance = m_cellularDistanceFunction;
+  params.cellular_return = m_cellularReturnType;
+  params.cellular_index0 = m_cellularDistanceIndex0;
+  params.cellular_index1 = m_cellularDistanceIndex1;
+  params.cellular_jitter = m_cellularJitter;
+  params.cellular_lookup = m_cellularNoiseLookup;
+  params.accumulate = false;
+  params.first_octave = 0;
+  params.weights = nullptr;
+}
+
+// Runs a batch through the selected kernels, or point by point through the
+// given single point methods if there are none. Noise types without a 4D single
+// point method pass null for it and evaluate the first 3 coordinates of 4D
+// batches, as their kernels do
+template <typename T>
+static void RunBatch(const FastNoiseT<T>& noise, const FastNoiseBatchParams<T>& params, typename BatchKernels<T>::Kernel BatchKernels<T>::* kernel, bool fractal,
+                     T (FastNoiseT<T>::*single2D)(T, T) const,
+                     T (FastNoiseT<T>::*single3D)(T, T, T) const,
+                     T (FastNoiseT<T>::*single4D)(T, T, T, T) const,
+                     int dims, const T* const* coords, T* out, int n)
+{
+  const BatchKernels<T>* kernels = GetBatchKernels<T>();
+  if (kernels != nullptr)
+  {
+    (kernels->*kernel)(params, dims, fractal, coords, out, n);
+    return;
+  }
+
+  if (dims > 3 && single4D == nullptr) dims = 3;
+  for (int i = 0; i < n; ++i)
+  {
+    switch (dims)
+    {
+    case 2:
+      out[i] = (noise.*single2D)(coords[0][i], coords[1][i]);
+      break;
+    case 3:
+      out[i] = (noise.*single3D)(coords[0][i], coords[1][i], coords[2][i]);
+      break;
+    default:
+      out[i] = (noise.*single4D)(coords[0][i], coords[1][i], coords[2][i], coords[3][i]);
+    }
+  }
+}
+
+template <typename T>
+void FastNoiseT<T>::GetSimplexBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::simplex, false, &FastNoiseT<T>::GetSimplex, &FastNoiseT<T>::GetSimplex, &FastNoiseT<T>::GetSimplex, dims, coords, out, n);
+}
+
+// There is no fractal 4D simplex noise, so 4D batches are evaluated as a single
+// octave like the kernels do
+template <typename T>
+void FastNoiseT<T>::GetSimplexFractalBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::simplex, true, &FastNoiseT<T>::GetSimplexFractal, &FastNoiseT<T>::GetSimplexFractal, &FastNoiseT<T>::GetSimplex, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetValueBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::value, false, &FastNoiseT<T>::GetValue, &FastNoiseT<T>::GetValue, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetValueFractalBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::value, true, &FastNoiseT<T>::GetValueFractal, &FastNoiseT<T>::GetValueFractal, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetPerlinBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::perlin, false, &FastNoiseT<T>::GetPerlin, &FastNoiseT<T>::GetPerlin, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetPerlinFractalBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::perlin, true, &FastNoiseT<T>::GetPerlinFractal, &FastNoiseT<T>::GetPerlinFractal, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetCubicBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::cubic, false, &FastNoiseT<T>::GetCubic, &FastNoiseT<T>::GetCubic, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetCubicFractalBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::cubic, true, &FastNoiseT<T>::GetCubicFractal, &FastNoiseT<T>::GetCubicFractal, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetCellularBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::cellular, false, &FastNoiseT<T>::GetCellular, &FastNoiseT<T>::GetCellular, nullptr, dims, coords, out, n);
+}
+
+template <typename T>
+void FastNoiseT<T>::GetCellularFractalBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  FastNoiseBatchParams<T> params;
+  BatchSetup(params);
+  RunBatch<T>(*this, params, &BatchKernels<T>::cellular, true, &FastNoiseT<T>::GetCellularFractal, &FastNoiseT<T>::GetCellularFractal, nullptr, dims, coords, out, n);
+}
+
+// Matches GetNoise(). White noise hashes the bits of each coordinate and has
+// no batch kernel
+template <typename T>
+void FastNoiseT<T>::GetNoiseBatch(int dims, const T* const* coords, T* out, int n) const
+{
+  switch (m_noiseType)
+  {
+  case Value: GetValueBatch(dims, coords, out, n); break;
+  case ValueFractal: GetValueFractalBatch(dims, coords, out, n); break;
+  case Perlin: GetPerlinBatch(dims, coords, out, n); break;
+  case PerlinFractal: GetPerlinFractalBatch(dims, coords, out, n); break;
+  case Simplex: GetSimplexBatch(dims, coords, out, n); break;
+  case SimplexFractal: GetSimplexFractalBatch(dims, coords, out, n); break;
+  case Cellular: GetCellularBatch(dims, coords, out, n); break;
+  case CellularFractal: GetCellularFractalBatch(dims, coords, out, n); break;
+  case Cubic: GetCubicBatch(dims, coords, out, n); break;
+  case CubicFractal: GetCubicFractalBatch(dims, coords, out, n); break;
+  case WhiteNoise:
+    for (int i = 0; i < n; ++i)
+    {
+      switch (dims)
+      {
+      case 2:
+        out[i] = GetWhiteNoise(coords[0][i] * m_frequency, coords[1][i] * m_frequency);
+        break;
+      case 3:
+        out[i] = GetWhiteNoise(coords[0][i] * m_frequency, coords[1][i] * m_frequency, coords[2][i] * m_frequency);
+        break;
+      default:
+        out[i] = GetWhiteNoise(coords[0][i] * m_frequency, coords[1][i] * m_frequency, coords[2][i] * m_frequency, coords[3][i] * m_frequency);
+      }
+    }
+    break;
+  default:
+    for (int i = 0; i < n; ++i) out[i] = 0;
+  }
+}
+
+// The octave noise of the fractal types, as used by their single point methods
+template <typename T>
+T FastNoiseT<T>::SingleOctave(unsigned char offset, int dims, T x, T y, T z) const
+{
+  switch (m_noiseType)
+  {
+  case ValueFractal: return dims == 2 ? SingleValue(offset, x, y) : SingleValue(offset, x, y, z);
+  case PerlinFractal: return dims == 2 ? SinglePerlin(offset, x, y) : SinglePerlin(offset, x, y, z);
+  case SimplexFractal: return dims == 2 ? SingleSimplex(offset, x, y) : SingleSimplex(offset, x, y, z);
+  case CubicFractal: return dims == 2 ? SingleCubic(offset, x, y) : SingleCubic(offset, x, y, z);
+  case CellularFractal: return dims == 2 ? SingleCellularBase(offset, x, y) : SingleCellularBase(offset, x, y, z);
+  default: return 0;
+  }
+}
+
+template <typename T>
+void FastNoiseT<T>::GetFractalOctavesBatch(int dims, const T* const* coords, T* sum, T* weight, int n, int first, int last) const
+{
+  typename BatchKernels<T>::Kernel BatchKernels<T>::* kernel;
+  switch (m_noiseType)
+  {
+  case ValueFractal: kernel = &BatchKernels<T>::value; break;
+  case PerlinFractal: kernel = &BatchKernels<T>::perlin; break;
+  case SimplexFractal: kernel = &BatchKernels<T>::simplex; break;
+  case CubicFractal: kernel = &BatchKernels<T>::cubic; break;
+  case CellularFractal: kernel = &BatchKernels<T>::cellular; break;
+  default: return;
+  }
+  first = std::max(first, 0);
+  last = std::min(last, m_octaves);
+  if (first >= last || dims < 2 || dims > 3) return;
+
+  const BatchKernels<T>* kernels = GetBatchKernels<T>();
+  if (kernels != nullptr)
+  {
+    FastNoiseBatchParams<T> params;
+    BatchSetup(params);
+    params.accumulate = true;
+    params.first_octave = first;
+    params.octaves = last;
+    params.weights = weight;
+    (kernels->*kernel)(params, dims, true, coords, sum, n);
+    return;
+  }
+
+  for (int i = 0; i < n; ++i)
+  {
+    T x = coords[0][i] * m_frequency;
+    T y = coords[1][i] * m_frequency;
+    T z = dims == 3 ? coords[2][i] * m_frequency : T(0);
+    T amp = 1;
+    for (int o = 0; o < last; ++o)
+    {
+      if (o > 0)
+      {
+        x *= m_lacunarity;
+        y *= m_lacunarity;
+        z *= m_lacunarity;
+        amp *= m_gain;
+      }
+      if (o < first) continue;
+      T noise = SingleOctave(m_perm[o], dims, x, y, z);
+      switch (m_fractalType)
+      {
+      case FBM:
+        sum[i] += noise * amp;
+        break;
+      case Billow:
+        sum[i] += (std::fabs(noise) * 2 - 1) * amp;
+        break;
+      case RigidMulti:
+      {
+        T sig = 1 - std::fabs(noise);
+        sig *= sig;
+        sig *= weight[i];
+        T next = sig * m_gain;
+        if (next > 1.0) {
+          next = 1.0;
+        }
+        if (next < 0.0) {
+          next = 0.0;
+        }
+        weight[i] = next;
+        sum[i] += (sig * m_pSpectralWeights[o]);
+        break;
+      }
+      }
+    }
+  }
+}
+
+template <typename T>
+void FastNoiseT<T>::FinishFractalBatch(const T* sum, T* out, int n) const
+{
+  if (m_fractalType == RigidMulti)
+  {
+    for (int i = 0; i < n; ++i) out[i] = (sum[i] * T(1.25)) - T(1.0);
+  }
+  else
+  {
+    for (int i = 0; i < n; ++i) out[i] = sum[i] * m_fractalBounding;
+  }
+}
+
+template void FastNoiseT<float>::BatchSetup(FastNoiseBatchParams<float>&) const;
+template void FastNoiseT<float>::GetSimplexBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetSimplexFractalBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetValueBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetValueFractalBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetPerlinBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetPerlinFractalBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetCubicBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetCubicFractalBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetCellularBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetCellularFractalBatch(int, const float* const*, float*, int) const;
+template void FastNoiseT<float>::GetNoiseBatch(int, const float* const*, float*, int) const;
+template float FastNoiseT<float>::SingleOctave(unsigned char, int, float, float, float) const;
+template void FastNoiseT<float>::GetFractalOctavesBatch(int, const float* const*, float*, float*, int, int, int) const;
+template void FastNoiseT<float>::FinishFractalBatch(const float*, float*, int) const;
+
+template void FastNoiseT<double>::BatchSetup(FastNoiseBatchParams<double>&) const;
+template void FastNoiseT<double>::GetSimplexBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetSimplexFractalBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetValueBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetValueFractalBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetPerlinBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetPerlinFractalBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetCubicBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetCubicFractalBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetCellularBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetCellularFractalBatch(int, const double* const*, double*, int) const;
+template void FastNoiseT<double>::GetNoiseBatch(int, const double* const*, double*, int) const;
+template double FastNoiseT<double>::SingleOctave(unsigned char, int, double, double, double) const;
+template void FastNoiseT<double>::GetFractalOctavesBatch(int, const double* const*, double*, double*, int, int, int) const;
+template void FastNoiseT<double>::FinishFractalBatch(const double*, double*, int) const;
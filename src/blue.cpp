@@ -0,0 +1,513 @@
+#include <cpp11/doubles.hpp>
+#include <cpp11/integers.hpp>
+#include <cpp11/matrix.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "grid_axis.h"
+
+// Kernel weights below this fraction of the largest weight are left out of the
+// energy updates
+static const double blue_kernel_tolerance = 1e-9;
+
+// Void-and-cluster on a periodic grid of up to four dimensions. The energy of
+// a pixel is the kernel-filtered binary pattern at that pixel and is updated in
+// place when a pixel flips by adding or subtracting the kernel centred on it.
+//
+// The tightest cluster (the set pixel with the highest energy) and the largest
+// void (the unset pixel with the lowest energy) are found with a tournament
+// tree over tiles of the grid for each. A flip only bounds how much the best
+// pixel of the tiles under the kernel can have improved, and a tile is
+// rescanned once its bound makes it to the top of the tree. Ties go to the
+// lowest index, like which.max() and which.min()
+class VoidAndCluster {
+public:
+  struct State {
+    std::vector<char> pattern;
+    std::vector<double> energy;
+  };
+
+  VoidAndCluster(const int* dim, int n_dim, const double* kernel) :
+    n_(1), set_side_(1, 1.0), unset_side_(0, -1.0) {
+    for (int d = 0; d < 4; ++d) {
+      dim_[d] = d < n_dim ? dim[d] : 1;
+      stride_[d] = n_;
+      n_ *= dim_[d];
+    }
+    init_stencil(kernel);
+    init_tiles();
+  }
+
+  const State& state() const { return state_; }
+
+  // Starts from the given binary pattern
+  void seed(const std::vector<char>& pattern) {
+    state_.pattern = pattern;
+    state_.energy.assign(n_, 0.0);
+    for (int i = 0; i < n_; ++i) {
+      if (pattern[i]) add_kernel(i, 1.0);
+    }
+    rebuild();
+  }
+
+  // Returns to an earlier state
+  void restore(const State& state) {
+    state_ = state;
+    rebuild();
+  }
+
+  // Sets or unsets a pixel, updating the energy around it
+  void set(int i, char value) {
+    if (state_.pattern[i] == value) return;
+    state_.pattern[i] = value;
+    double sign = value ? 1.0 : -1.0;
+    add_kernel(i, sign);
+    bound_tiles(set_side_, i, sign);
+    bound_tiles(unset_side_, i, sign);
+  }
+
+  // The set pixel with the highest energy
+  int tightest_cluster() { return best(set_side_); }
+  // The unset pixel with the lowest energy
+  int largest_void() { return best(unset_side_); }
+
+private:
+  static constexpr double inf = std::numeric_limits<double>::infinity();
+
+  int n_;
+  int dim_[4];
+  int stride_[4];
+  State state_;
+
+  // The kernel restricted to the box of offsets where it is above tolerance.
+  // Offsets along dimension d run from low_[d] to high_[d]
+  int low_[4];
+  int high_[4];
+  int box_[4];
+  std::vector<double> weights_;
+
+  // The largest increase and decrease a flip makes to the energy
+  double max_increase_;
+  double max_decrease_;
+
+  // A tile's best pixel, or an optimistic bound on it if the tile is stale.
+  // Values are multiplied by the direction of the side so higher is better
+  struct Key {
+    double value;
+    int index;
+  };
+  // The tiles and tournament tree for finding the best pixel with a given
+  // value in the pattern
+  struct Side {
+    Side(char value, double direction) : value(value), direction(direction) {}
+    char value;
+    double direction;
+    std::vector<Key> tree;
+    std::vector<char> stale;
+  };
+
+  int tile_[4];
+  int n_tile_[4];
+  int n_tiles_;
+  int tree_size_;
+  Side set_side_;
+  Side unset_side_;
+
+  // Scratch space for flips
+  std::vector<int> touched_[4];
+  std::vector<int> tiles_;
+  std::vector<int> nodes_;
+  std::vector<int> stamp_;
+  int stamp_id_;
+
+  static int wrap(int x, int n) {
+    x %= n;
+    return x < 0 ? x + n : x;
+  }
+
+  void coordinates(int i, int* c) const {
+    for (int d = 0; d < 4; ++d) c[d] = (i / stride_[d]) % dim_[d];
+  }
+
+  void init_stencil(const double* kernel) {
+    double max = 0.0;
+    for (int i = 0; i < n_; ++i) max = std::max(max, std::fabs(kernel[i]));
+    double cutoff = max * blue_kernel_tolerance;
+    int radius[4] = {0, 0, 0, 0};
+    int c[4];
+    for (int i = 0; i < n_; ++i) {
+      if (std::fabs(kernel[i]) <= cutoff) continue;
+      coordinates(i, c);
+      for (int d = 0; d < 4; ++d) {
+        radius[d] = std::max(radius[d], std::min(c[d], dim_[d] - c[d]));
+      }
+    }
+    // The kernel holds each periodic offset once, so the box may not wrap
+    // around onto itself
+    int size = 1;
+    for (int d = 0; d < 4; ++d) {
+      low_[d] = -std::min(radius[d], (dim_[d] - 1) / 2);
+      high_[d] = std::min(radius[d], dim_[d] / 2);
+      box_[d] = high_[d] - low_[d] + 1;
+      size *= box_[d];
+    }
+    weights_.resize(size);
+    max_increase_ = 0.0;
+    max_decrease_ = 0.0;
+    int o[4];
+    int k = 0;
+    for (o[3] = low_[3]; o[3] <= high_[3]; ++o[3]) {
+      for (o[2] = low_[2]; o[2] <= high_[2]; ++o[2]) {
+        for (o[1] = low_[1]; o[1] <= high_[1]; ++o[1]) {
+          for (o[0] = low_[0]; o[0] <= high_[0]; ++o[0]) {
+            int idx = 0;
+            for (int d = 0; d < 4; ++d) idx += wrap(o[d], dim_[d]) * stride_[d];
+            double w = std::fabs(kernel[idx]) <= cutoff ? 0.0 : kernel[idx];
+            max_increase_ = std::max(max_increase_, w);
+            max_decrease_ = std::max(max_decrease_, -w);
+            weights_[k++] = w;
+          }
+        }
+      }
+    }
+  }
+
+  // Tiles hold around 256 pixels regardless of the number of dimensions
+  void init_tiles() {
+    int active = 0;
+    for (int d = 0; d < 4; ++d) active += dim_[d] > 1;
+    int side = active < 2 ? 256 : (int) std::lround(std::pow(256.0, 1.0 / active));
+    n_tiles_ = 1;
+    for (int d = 0; d < 4; ++d) {
+      tile_[d] = std::min(side, dim_[d]);
+      n_tile_[d] = (dim_[d] + tile_[d] - 1) / tile_[d];
+      n_tiles_ *= n_tile_[d];
+      touched_[d].resize(n_tile_[d]);
+    }
+    tree_size_ = 1;
+    while (tree_size_ < n_tiles_) tree_size_ *= 2;
+    Key empty = {-inf, n_};
+    for (Side* side : {&set_side_, &unset_side_}) {
+      side->tree.assign(2 * tree_size_, empty);
+      side->stale.assign(n_tiles_, 0);
+    }
+    stamp_.assign(2 * tree_size_, 0);
+    stamp_id_ = 0;
+  }
+
+  void rebuild() {
+    for (Side* side : {&set_side_, &unset_side_}) {
+      for (int t = 0; t < n_tiles_; ++t) scan_tile(*side, t);
+      for (int i = tree_size_ - 1; i > 0; --i) update_node(*side, i);
+    }
+  }
+
+  static bool better(const Key& a, const Key& b) {
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+  }
+
+  void tile_range(int t, int* start, int* end) const {
+    for (int d = 0; d < 4; ++d) {
+      start[d] = (t % n_tile_[d]) * tile_[d];
+      end[d] = std::min(start[d] + tile_[d], dim_[d]);
+      t /= n_tile_[d];
+    }
+  }
+
+  int tile_of(int i) const {
+    int c[4];
+    coordinates(i, c);
+    int t = 0;
+    for (int d = 3; d >= 0; --d) t = t * n_tile_[d] + c[d] / tile_[d];
+    return t;
+  }
+
+  // Finds the best pixel of a tile exactly, visiting the pixels in increasing
+  // index so the lowest index is kept
+  void scan_tile(Side& side, int t) {
+    int start[4], end[4];
+    tile_range(t, start, end);
+    const char* pattern = state_.pattern.data();
+    const double* energy = state_.energy.data();
+    Key key = {-inf, n_};
+    for (int x3 = start[3]; x3 < end[3]; ++x3) {
+      for (int x2 = start[2]; x2 < end[2]; ++x2) {
+        for (int x1 = start[1]; x1 < end[1]; ++x1) {
+          int row = x1 * stride_[1] + x2 * stride_[2] + x3 * stride_[3];
+          for (int i = row + start[0]; i < row + end[0]; ++i) {
+            if (pattern[i] != side.value) continue;
+            double value = side.direction * energy[i];
+            if (key.index == n_ || value > key.value) {
+              key.value = value;
+              key.index = i;
+            }
+          }
+        }
+      }
+    }
+    side.tree[tree_size_ + t] = key;
+    side.stale[t] = 0;
+  }
+
+  void update_node(Side& side, int i) {
+    const Key& l = side.tree[2 * i];
+    const Key& r = side.tree[2 * i + 1];
+    side.tree[i] = better(r, l) ? r : l;
+  }
+
+  // The best pixel of a side. Stale tiles reaching the top of the tree are
+  // rescanned until the top is exact, at which point no bound beats it
+  int best(Side& side) {
+    while (true) {
+      const Key& top = side.tree[1];
+      if (top.index == n_) return -1;
+      int t = tile_of(top.index);
+      if (!side.stale[t]) return top.index;
+      scan_tile(side, t);
+      for (int node = (tree_size_ + t) / 2; node > 0; node /= 2) update_node(side, node);
+    }
+  }
+
+  void add_kernel(int i, double sign) {
+    int c[4];
+    coordinates(i, c);
+    // Along the first dimension the box is at most split in two by wrapping
+    int first = wrap(c[0] + low_[0], dim_[0]);
+    int split = std::min(box_[0], dim_[0] - first);
+    const double* w = weights_.data();
+    for (int o3 = low_[3]; o3 <= high_[3]; ++o3) {
+      int i3 = wrap(c[3] + o3, dim_[3]) * stride_[3];
+      for (int o2 = low_[2]; o2 <= high_[2]; ++o2) {
+        int i2 = i3 + wrap(c[2] + o2, dim_[2]) * stride_[2];
+        for (int o1 = low_[1]; o1 <= high_[1]; ++o1) {
+          double* row = state_.energy.data() + i2 + wrap(c[1] + o1, dim_[1]) * stride_[1];
+          for (int o = 0; o < split; ++o) row[first + o] += sign * w[o];
+          for (int o = split; o < box_[0]; ++o) row[o - split] += sign * w[o];
+          w += box_[0];
+        }
+      }
+    }
+  }
+
+  // The tiles along one dimension that the kernel touches when centred at x.
+  // These are consecutive apart from wrapping around to the first tile, so a
+  // tile can only repeat the previous one or the one we started in
+  int touched_tiles(int d, int x, int* tiles) const {
+    int n = 0;
+    for (int o = low_[d]; o <= high_[d] && n < n_tile_[d]; ++o) {
+      int t = wrap(x + o, dim_[d]) / tile_[d];
+      if (n == 0 || (t != tiles[n - 1] && t != tiles[0])) tiles[n++] = t;
+    }
+    return n;
+  }
+
+  // Relaxes the keys of every tile the kernel centred on pixel i touches to
+  // bounds on how much their best pixel may have improved, and updates the
+  // tree above them one level at a time. Pixel i itself has just joined or
+  // left the side, and is included exactly if it joined
+  void bound_tiles(Side& side, int i, double sign) {
+    if (tiles_.empty() || tiles_[0] != i) {
+      int c[4];
+      coordinates(i, c);
+      int n_touched[4];
+      for (int d = 0; d < 4; ++d) n_touched[d] = touched_tiles(d, c[d], touched_[d].data());
+      tiles_.assign(1, i);
+      for (int a = 0; a < n_touched[3]; ++a) {
+        for (int b = 0; b < n_touched[2]; ++b) {
+          for (int e = 0; e < n_touched[1]; ++e) {
+            for (int f = 0; f < n_touched[0]; ++f) {
+              tiles_.push_back(touched_[0][f] + n_tile_[0] * (touched_[1][e] + n_tile_[1] * (touched_[2][b] + n_tile_[2] * touched_[3][a])));
+            }
+          }
+        }
+      }
+    }
+    double increase = sign * side.direction > 0 ? max_increase_ : max_decrease_;
+    int own_tile = tile_of(i);
+    bool joined = state_.pattern[i] == side.value;
+    Key own = {side.direction * state_.energy[i], i};
+    nodes_.clear();
+    for (size_t k = 1; k < tiles_.size(); ++k) {
+      int t = tiles_[k];
+      Key& key = side.tree[tree_size_ + t];
+      if (key.index != n_) {
+        key.value += increase;
+        int start[4], end[4];
+        tile_range(t, start, end);
+        key.index = start[0] + start[1] * stride_[1] + start[2] * stride_[2] + start[3] * stride_[3];
+      }
+      if (t == own_tile && joined && (key.index == n_ || better(own, key))) key = own;
+      side.stale[t] = 1;
+      nodes_.push_back(tree_size_ + t);
+    }
+    while (nodes_[0] > 1) {
+      ++stamp_id_;
+      size_t n_parents = 0;
+      for (size_t k = 0; k < nodes_.size(); ++k) {
+        int parent = nodes_[k] / 2;
+        if (stamp_[parent] == stamp_id_) continue;
+        stamp_[parent] = stamp_id_;
+        update_node(side, parent);
+        nodes_[n_parents++] = parent;
+      }
+      nodes_.resize(n_parents);
+    }
+  }
+};
+
+constexpr double VoidAndCluster::inf;
+
+// Ranks every pixel of a periodic grid using void-and-cluster, starting from
+// the binary `seed` pattern. `kernel` is the spatial filter used to measure
+// clustering, stored in the same layout as the grid with the zero offset
+// first. Returns the rank of each pixel from 0 to n - 1
+[[cpp11::register]]
+cpp11::writable::doubles blue_noise_c(cpp11::integers dim, cpp11::doubles kernel, cpp11::integers seed) {
+  int n_dim = dim.size();
+  if (n_dim < 1 || n_dim > 4) cpp11::stop("Blue noise can only be generated in 1 to 4 dimensions");
+  std::vector<int> dims(n_dim);
+  int n = 1;
+  for (int d = 0; d < n_dim; ++d) {
+    dims[d] = dim[d];
+    n *= dims[d];
+  }
+  if (n < 2) cpp11::stop("Blue noise requires at least two pixels");
+  if (kernel.size() != n || seed.size() != n) cpp11::stop("kernel and seed must match the dimensions");
+
+  std::vector<char> pattern(n);
+  int n_seeds = 0;
+  for (int i = 0; i < n; ++i) {
+    pattern[i] = seed[i] != 0;
+    n_seeds += pattern[i];
+  }
+  VoidAndCluster vac(dims.data(), n_dim, REAL(kernel));
+  vac.seed(pattern);
+
+  // Move the tightest cluster to the largest void until the pattern is stable.
+  // Exact ties can make the pattern alternate between two states so the
+  // number of moves is bounded
+  for (int moves = 0; moves < n; ++moves) {
+    int tightest = vac.tightest_cluster();
+    vac.set(tightest, 0);
+    int largest_void = vac.largest_void();
+    vac.set(largest_void, 1);
+    if (tightest == largest_void) break;
+  }
+  VoidAndCluster::State initial = vac.state();
+
+  cpp11::writable::doubles rank(n);
+  double* out = REAL(rank.data());
+  // Remove the tightest clusters of the initial pattern one at a time
+  for (int i = n_seeds - 1; i >= 0; --i) {
+    int tightest = vac.tightest_cluster();
+    vac.set(tightest, 0);
+    out[tightest] = i;
+  }
+  // Fill the largest voids until the grid is full. Once more than half the
+  // pixels are set this is the tightest cluster of the unset pixels
+  vac.restore(initial);
+  for (int i = n_seeds; i < n; ++i) {
+    int largest_void = vac.largest_void();
+    vac.set(largest_void, 1);
+    out[largest_void] = i;
+  }
+  return rank;
+}
+
+// Larger blue noise textures are assembled from a small library of square
+// tiles. Each tile of the plane is a randomly chosen tile of the library,
+// shifted by a random toroidal offset so the repetition is not visible. The
+// choice only depends on the seed and the position of the tile so any pixel
+// can be looked up on its own
+struct BlueTilePlacement {
+  int tile;
+  int dx;
+  int dy;
+};
+
+inline uint64_t blue_mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+inline BlueTilePlacement blue_placement(int seed, int tx, int ty, int n_tiles, int size) {
+  uint64_t h = blue_mix(((uint64_t) (uint32_t) tx << 32) | (uint32_t) ty);
+  h = blue_mix(h ^ ((uint64_t) (uint32_t) seed * 0x9e3779b97f4a7c15ULL));
+  BlueTilePlacement placement = {(int) (h % n_tiles), (int) ((h >> 24) % size), (int) ((h >> 44) % size)};
+  return placement;
+}
+
+inline int blue_floor_div(int a, int b) {
+  int q = a / b;
+  return a % b < 0 ? q - 1 : q;
+}
+
+inline int blue_n_tiles(const cpp11::doubles& tiles, int size) {
+  if (size < 1) cpp11::stop("tile size must be positive");
+  R_xlen_t tile_length = (R_xlen_t) size * size;
+  if (tiles.size() == 0 || tiles.size() % tile_length != 0) cpp11::stop("tiles must hold a whole number of tiles");
+  return tiles.size() / tile_length;
+}
+
+// A height x width texture from the tile library. `tiles` holds the tiles one
+// after another, each as a column-major size x size matrix. Columns are copied
+// in runs along the rows of a tile
+[[cpp11::register]]
+cpp11::writable::doubles_matrix<> blue_tiled_c(cpp11::doubles tiles, int size, int height, int width, int seed) {
+  int n_tiles = blue_n_tiles(tiles, size);
+  cpp11::writable::doubles_matrix<> noise(height, width);
+  double* out = REAL(noise.data());
+  const double* library = REAL(tiles);
+  for (int j = 0; j < width; ++j) {
+    int tx = j / size;
+    int cx = j % size;
+    double* column = out + (R_xlen_t) j * height;
+    for (int i0 = 0; i0 < height; i0 += size) {
+      BlueTilePlacement placement = blue_placement(seed, tx, i0 / size, n_tiles, size);
+      const double* source = library + (R_xlen_t) placement.tile * size * size + (R_xlen_t) ((cx + placement.dx) % size) * size;
+      int rows = std::min(size, height - i0);
+      int first = std::min(rows, size - placement.dy);
+      std::memcpy(column + i0, source + placement.dy, first * sizeof(double));
+      std::memcpy(column + i0 + first, source, (rows - first) * sizeof(double));
+    }
+  }
+  return noise;
+}
+
+// Blue noise at arbitrary coordinates. Coordinates are scaled by the frequency
+// and floored to the pixel they fall in, with x running along the columns and
+// y along the rows as in blue_tiled_c()
+[[cpp11::register]]
+cpp11::writable::doubles gen_blue_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles tiles, int size, double freq, int seed) {
+  int n_tiles = blue_n_tiles(tiles, size);
+  R_xlen_t n = x.size();
+  cpp11::writable::doubles noise(n);
+  double* out = REAL(noise.data());
+  const PointAxis px = point_axis(x);
+  const PointAxis py = point_axis(y);
+  const double* library = REAL(tiles);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    double fx = std::floor(px[i] * freq);
+    double fy = std::floor(py[i] * freq);
+    // Pixels outside the range of int (including infinite coordinates) can't
+    // be placed in a tile
+    if (!std::isfinite(fx) || !std::isfinite(fy) || fx < INT_MIN || fx > INT_MAX || fy < INT_MIN || fy > INT_MAX) {
+      out[i] = NA_REAL;
+      continue;
+    }
+    int ix = (int) fx;
+    int iy = (int) fy;
+    int tx = blue_floor_div(ix, size);
+    int ty = blue_floor_div(iy, size);
+    BlueTilePlacement placement = blue_placement(seed, tx, ty, n_tiles, size);
+    int col = (ix - tx * size + placement.dx) % size;
+    int row = (iy - ty * size + placement.dy) % size;
+    out[i] = library[(R_xlen_t) placement.tile * size * size + (R_xlen_t) col * size + row];
+  }
+  return noise;
+}
@@ -5,239 +5,415 @@
 #include "cpp11/declarations.hpp"
 #include <R_ext/Visibility.h>
 
+// blue.cpp
+cpp11::writable::doubles blue_noise_c(cpp11::integers dim, cpp11::doubles kernel, cpp11::integers seed);
+extern "C" SEXP _ambient_blue_noise_c(SEXP dim, SEXP kernel, SEXP seed) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(blue_noise_c(cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dim), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(kernel), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(seed)));
+  END_CPP11
+}
+// blue.cpp
+cpp11::writable::doubles_matrix<> blue_tiled_c(cpp11::doubles tiles, int size, int height, int width, int seed);
+extern "C" SEXP _ambient_blue_tiled_c(SEXP tiles, SEXP size, SEXP height, SEXP width, SEXP seed) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(blue_tiled_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(tiles), cpp11::as_cpp<cpp11::decay_t<int>>(size), cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+  END_CPP11
+}
+// blue.cpp
+cpp11::writable::doubles gen_blue_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles tiles, int size, double freq, int seed);
+extern "C" SEXP _ambient_gen_blue_c(SEXP x, SEXP y, SEXP tiles, SEXP size, SEXP freq, SEXP seed) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(gen_blue_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(tiles), cpp11::as_cpp<cpp11::decay_t<int>>(size), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+  END_CPP11
+}
 // cubic.cpp
-cpp11::writable::doubles_matrix<> cubic_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_cubic_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> cubic_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_cubic_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(cubic_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(cubic_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // cubic.cpp
-cpp11::writable::doubles_matrix<> cubic_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_cubic_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> cubic_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_cubic_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(cubic_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(cubic_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // cubic.cpp
-cpp11::writable::doubles gen_cubic2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed);
-extern "C" SEXP _ambient_gen_cubic2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_cubic2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_cubic2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_cubic2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_cubic2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // cubic.cpp
-cpp11::writable::doubles gen_cubic3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed);
-extern "C" SEXP _ambient_gen_cubic3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_cubic3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_cubic3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(gen_cubic3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// curl.cpp
+cpp11::writable::list curl_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::list seeds, cpp11::doubles gain, int interp, cpp11::doubles fractal_args, int curl_dims, int threads, bool single);
+extern "C" SEXP _ambient_curl_c(SEXP type, SEXP fractal, SEXP coords, SEXP freq, SEXP seeds, SEXP gain, SEXP interp, SEXP fractal_args, SEXP curl_dims, SEXP threads, SEXP single) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(curl_c(cpp11::as_cpp<cpp11::decay_t<int>>(type), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(coords), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(freq), cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(seeds), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(fractal_args), cpp11::as_cpp<cpp11::decay_t<int>>(curl_dims), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// fracture.cpp
+cpp11::writable::doubles fracture_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::integers seed, cpp11::doubles gain, int interp, int dist, int value, cpp11::integers dist2ind, double jitter, cpp11::doubles fractal_args, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_fracture_c(SEXP type, SEXP fractal, SEXP coords, SEXP freq, SEXP seed, SEXP gain, SEXP interp, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP fractal_args, SEXP threads, SEXP presort, SEXP single) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(fracture_c(cpp11::as_cpp<cpp11::decay_t<int>>(type), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(coords), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(freq), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(seed), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(fractal_args), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// gradient.cpp
+cpp11::writable::list gradient_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::integers seed, cpp11::doubles gain, int interp, int dist, int value, cpp11::integers dist2ind, double jitter, cpp11::doubles fractal_args, int threads);
+extern "C" SEXP _ambient_gradient_c(SEXP type, SEXP fractal, SEXP coords, SEXP freq, SEXP seed, SEXP gain, SEXP interp, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP fractal_args, SEXP threads) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(gradient_c(cpp11::as_cpp<cpp11::decay_t<int>>(type), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(coords), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(freq), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(seed), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(fractal_args), cpp11::as_cpp<cpp11::decay_t<int>>(threads)));
+  END_CPP11
+}
+// grid_axis.cpp
+SEXP grid_axis_c(SEXP values, double each, double length);
+extern "C" SEXP _ambient_grid_axis_c(SEXP values, SEXP each, SEXP length) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(grid_axis_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(values), cpp11::as_cpp<cpp11::decay_t<double>>(each), cpp11::as_cpp<cpp11::decay_t<double>>(length)));
+  END_CPP11
+}
+// handle.cpp
+SEXP noise_handle_c(int type, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_noise_handle_c(SEXP type, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_cubic3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(noise_handle_c(cpp11::as_cpp<cpp11::decay_t<int>>(type), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// handle.cpp
+cpp11::writable::doubles noise_handle_eval_c(SEXP handle, SEXP x, SEXP y, SEXP z, SEXP t);
+extern "C" SEXP _ambient_noise_handle_eval_c(SEXP handle, SEXP x, SEXP y, SEXP z, SEXP t) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_handle_eval_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(handle), cpp11::as_cpp<cpp11::decay_t<SEXP>>(x), cpp11::as_cpp<cpp11::decay_t<SEXP>>(y), cpp11::as_cpp<cpp11::decay_t<SEXP>>(z), cpp11::as_cpp<cpp11::decay_t<SEXP>>(t)));
+  END_CPP11
+}
+// lazy_noise.cpp
+std::string noise_settings_key_c(cpp11::list config);
+extern "C" SEXP _ambient_noise_settings_key_c(SEXP config) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_settings_key_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config)));
+  END_CPP11
+}
+// lazy_noise.cpp
+SEXP noise_lazy_c(cpp11::list config);
+extern "C" SEXP _ambient_noise_lazy_c(SEXP config) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_lazy_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config)));
+  END_CPP11
+}
+// parallel.cpp
+void pool_shutdown_c();
+extern "C" SEXP _ambient_pool_shutdown_c() {
+  BEGIN_CPP11
+    pool_shutdown_c();
+    return R_NilValue;
   END_CPP11
 }
 // perlin.cpp
-cpp11::writable::doubles_matrix<> perlin_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_perlin_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> perlin_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_perlin_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(perlin_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(perlin_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // perlin.cpp
-cpp11::writable::doubles_matrix<> perlin_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_perlin_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> perlin_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_perlin_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(perlin_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(perlin_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // perlin.cpp
-cpp11::writable::doubles gen_perlin2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp);
-extern "C" SEXP _ambient_gen_perlin2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP interp) {
+cpp11::writable::doubles gen_perlin2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_perlin2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP interp, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_perlin2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp)));
+    return cpp11::as_sexp(gen_perlin2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // perlin.cpp
-cpp11::writable::doubles gen_perlin3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp);
-extern "C" SEXP _ambient_gen_perlin3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP interp) {
+cpp11::writable::doubles gen_perlin3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_perlin3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP interp, SEXP threads, SEXP presort, SEXP single) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(gen_perlin3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// progressive.cpp
+SEXP noise_progressive_c(cpp11::list config);
+extern "C" SEXP _ambient_noise_progressive_c(SEXP config) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_progressive_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config)));
+  END_CPP11
+}
+// progressive.cpp
+cpp11::integers noise_progressive_octaves_c(SEXP progressive);
+extern "C" SEXP _ambient_noise_progressive_octaves_c(SEXP progressive) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_progressive_octaves_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(progressive)));
+  END_CPP11
+}
+// progressive.cpp
+SEXP noise_progressive_refine_c(SEXP progressive, int octaves);
+extern "C" SEXP _ambient_noise_progressive_refine_c(SEXP progressive, SEXP octaves) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_progressive_refine_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(progressive), cpp11::as_cpp<cpp11::decay_t<int>>(octaves)));
+  END_CPP11
+}
+// pyramid.cpp
+SEXP noise_pyramid_c(cpp11::list config, int levels);
+extern "C" SEXP _ambient_noise_pyramid_c(SEXP config, SEXP levels) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_perlin3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp)));
+    return cpp11::as_sexp(noise_pyramid_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config), cpp11::as_cpp<cpp11::decay_t<int>>(levels)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles_matrix<> simplex_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_simplex_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> simplex_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_simplex_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(simplex_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(simplex_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles_matrix<> simplex_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_simplex_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> simplex_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_simplex_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(simplex_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(simplex_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles_matrix<> simplex_4d_c(int height, int width, int depth, int time, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_simplex_4d_c(SEXP height, SEXP width, SEXP depth, SEXP time, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> simplex_4d_c(int height, int width, int depth, int time, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_simplex_4d_c(SEXP height, SEXP width, SEXP depth, SEXP time, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(simplex_4d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(time), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(simplex_4d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(time), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles gen_simplex2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed);
-extern "C" SEXP _ambient_gen_simplex2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_simplex2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_simplex2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_simplex2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_simplex2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles gen_simplex3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed);
-extern "C" SEXP _ambient_gen_simplex3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_simplex3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_simplex3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_simplex3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_simplex3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // simplex.cpp
-cpp11::writable::doubles gen_simplex4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed);
-extern "C" SEXP _ambient_gen_simplex4d_c(SEXP x, SEXP y, SEXP z, SEXP t, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_simplex4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_simplex4d_c(SEXP x, SEXP y, SEXP z, SEXP t, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_simplex4d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(t), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_simplex4d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(t), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// tiles.cpp
+SEXP noise_tiles_c(cpp11::list config, int size, int halo);
+extern "C" SEXP _ambient_noise_tiles_c(SEXP config, SEXP size, SEXP halo) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_tiles_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config), cpp11::as_cpp<cpp11::decay_t<int>>(size), cpp11::as_cpp<cpp11::decay_t<int>>(halo)));
+  END_CPP11
+}
+// tiles.cpp
+std::string noise_tiles_key_c(SEXP tiles);
+extern "C" SEXP _ambient_noise_tiles_key_c(SEXP tiles) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_tiles_key_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(tiles)));
+  END_CPP11
+}
+// tiles.cpp
+SEXP noise_tile_c(SEXP tiles, double x, double y, double z, double cache_size, SEXP dir);
+extern "C" SEXP _ambient_noise_tile_c(SEXP tiles, SEXP x, SEXP y, SEXP z, SEXP cache_size, SEXP dir) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(noise_tile_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(tiles), cpp11::as_cpp<cpp11::decay_t<double>>(x), cpp11::as_cpp<cpp11::decay_t<double>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(cache_size), cpp11::as_cpp<cpp11::decay_t<SEXP>>(dir)));
   END_CPP11
 }
 // value.cpp
-cpp11::writable::doubles_matrix<> value_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_value_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> value_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_value_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(value_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(value_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // value.cpp
-cpp11::writable::doubles_matrix<> value_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_value_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> value_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_value_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP interp, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(value_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(value_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // value.cpp
-cpp11::writable::doubles gen_value2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp);
-extern "C" SEXP _ambient_gen_value2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP interp) {
+cpp11::writable::doubles gen_value2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_value2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP interp, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_value2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp)));
+    return cpp11::as_sexp(gen_value2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // value.cpp
-cpp11::writable::doubles gen_value3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp);
-extern "C" SEXP _ambient_gen_value3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP interp) {
+cpp11::writable::doubles gen_value3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_value3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP interp, SEXP threads, SEXP presort, SEXP single) {
+  BEGIN_CPP11
+    return cpp11::as_sexp(gen_value3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
+  END_CPP11
+}
+// volume.cpp
+void noise_file_c(cpp11::list config, std::string path);
+extern "C" SEXP _ambient_noise_file_c(SEXP config, SEXP path) {
+  BEGIN_CPP11
+    noise_file_c(cpp11::as_cpp<cpp11::decay_t<cpp11::list>>(config), cpp11::as_cpp<cpp11::decay_t<std::string>>(path));
+    return R_NilValue;
+  END_CPP11
+}
+// volume.cpp
+SEXP noise_read_c(SEXP path);
+extern "C" SEXP _ambient_noise_read_c(SEXP path) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_value3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(interp)));
+    return cpp11::as_sexp(noise_read_c(cpp11::as_cpp<cpp11::decay_t<SEXP>>(path)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles_matrix<> white_2d_c(int height, int width, int seed, double freq, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_white_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> white_2d_c(int height, int width, int seed, double freq, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_white_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(white_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(white_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles_matrix<> white_3d_c(int height, int width, int depth, int seed, double freq, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_white_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> white_3d_c(int height, int width, int depth, int seed, double freq, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_white_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(white_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(white_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles_matrix<> white_4d_c(int height, int width, int depth, int time, int seed, double freq, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_white_4d_c(SEXP height, SEXP width, SEXP depth, SEXP time, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> white_4d_c(int height, int width, int depth, int time, int seed, double freq, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_white_4d_c(SEXP height, SEXP width, SEXP depth, SEXP time, SEXP seed, SEXP freq, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(white_4d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(time), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(white_4d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(time), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles gen_white2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed);
-extern "C" SEXP _ambient_gen_white2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_white2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_white2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_white2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_white2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles gen_white3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed);
-extern "C" SEXP _ambient_gen_white3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_white3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_white3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_white3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_white3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // white.cpp
-cpp11::writable::doubles gen_white4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed);
-extern "C" SEXP _ambient_gen_white4d_c(SEXP x, SEXP y, SEXP z, SEXP t, SEXP freq, SEXP seed) {
+cpp11::writable::doubles gen_white4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_white4d_c(SEXP x, SEXP y, SEXP z, SEXP t, SEXP freq, SEXP seed, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_white4d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(t), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed)));
+    return cpp11::as_sexp(gen_white4d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(t), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // worley.cpp
-cpp11::writable::doubles_matrix<> worley_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_worley_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> worley_2d_c(int height, int width, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_worley_2d_c(SEXP height, SEXP width, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(worley_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(worley_2d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // worley.cpp
-cpp11::writable::doubles_matrix<> worley_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp);
-extern "C" SEXP _ambient_worley_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP pertube, SEXP pertube_amp) {
+cpp11::writable::doubles_matrix<> worley_3d_c(int height, int width, int depth, int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp, int threads, bool single);
+extern "C" SEXP _ambient_worley_3d_c(SEXP height, SEXP width, SEXP depth, SEXP seed, SEXP freq, SEXP fractal, SEXP octaves, SEXP lacunarity, SEXP gain, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP pertube, SEXP pertube_amp, SEXP threads, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(worley_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp)));
+    return cpp11::as_sexp(worley_3d_c(cpp11::as_cpp<cpp11::decay_t<int>>(height), cpp11::as_cpp<cpp11::decay_t<int>>(width), cpp11::as_cpp<cpp11::decay_t<int>>(depth), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(fractal), cpp11::as_cpp<cpp11::decay_t<int>>(octaves), cpp11::as_cpp<cpp11::decay_t<double>>(lacunarity), cpp11::as_cpp<cpp11::decay_t<double>>(gain), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(pertube), cpp11::as_cpp<cpp11::decay_t<double>>(pertube_amp), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // worley.cpp
-cpp11::writable::doubles gen_worley2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int dist, int value, cpp11::integers dist2ind, double jitter);
-extern "C" SEXP _ambient_gen_worley2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter) {
+cpp11::writable::doubles gen_worley2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int dist, int value, cpp11::integers dist2ind, double jitter, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_worley2d_c(SEXP x, SEXP y, SEXP freq, SEXP seed, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_worley2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter)));
+    return cpp11::as_sexp(gen_worley2d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 // worley.cpp
-cpp11::writable::doubles gen_worley3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int dist, int value, cpp11::integers dist2ind, double jitter);
-extern "C" SEXP _ambient_gen_worley3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter) {
+cpp11::writable::doubles gen_worley3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int dist, int value, cpp11::integers dist2ind, double jitter, int threads, bool presort, bool single);
+extern "C" SEXP _ambient_gen_worley3d_c(SEXP x, SEXP y, SEXP z, SEXP freq, SEXP seed, SEXP dist, SEXP value, SEXP dist2ind, SEXP jitter, SEXP threads, SEXP presort, SEXP single) {
   BEGIN_CPP11
-    return cpp11::as_sexp(gen_worley3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter)));
+    return cpp11::as_sexp(gen_worley3d_c(cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(x), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(y), cpp11::as_cpp<cpp11::decay_t<cpp11::doubles>>(z), cpp11::as_cpp<cpp11::decay_t<double>>(freq), cpp11::as_cpp<cpp11::decay_t<int>>(seed), cpp11::as_cpp<cpp11::decay_t<int>>(dist), cpp11::as_cpp<cpp11::decay_t<int>>(value), cpp11::as_cpp<cpp11::decay_t<cpp11::integers>>(dist2ind), cpp11::as_cpp<cpp11::decay_t<double>>(jitter), cpp11::as_cpp<cpp11::decay_t<int>>(threads), cpp11::as_cpp<cpp11::decay_t<bool>>(presort), cpp11::as_cpp<cpp11::decay_t<bool>>(single)));
   END_CPP11
 }
 
 extern "C" {
 static const R_CallMethodDef CallEntries[] = {
-    {"_ambient_cubic_2d_c",      (DL_FUNC) &_ambient_cubic_2d_c,      10},
-    {"_ambient_cubic_3d_c",      (DL_FUNC) &_ambient_cubic_3d_c,      11},
-    {"_ambient_gen_cubic2d_c",   (DL_FUNC) &_ambient_gen_cubic2d_c,    4},
-    {"_ambient_gen_cubic3d_c",   (DL_FUNC) &_ambient_gen_cubic3d_c,    5},
-    {"_ambient_gen_perlin2d_c",  (DL_FUNC) &_ambient_gen_perlin2d_c,   5},
-    {"_ambient_gen_perlin3d_c",  (DL_FUNC) &_ambient_gen_perlin3d_c,   6},
-    {"_ambient_gen_simplex2d_c", (DL_FUNC) &_ambient_gen_simplex2d_c,  4},
-    {"_ambient_gen_simplex3d_c", (DL_FUNC) &_ambient_gen_simplex3d_c,  5},
-    {"_ambient_gen_simplex4d_c", (DL_FUNC) &_ambient_gen_simplex4d_c,  6},
-    {"_ambient_gen_value2d_c",   (DL_FUNC) &_ambient_gen_value2d_c,    5},
-    {"_ambient_gen_value3d_c",   (DL_FUNC) &_ambient_gen_value3d_c,    6},
-    {"_ambient_gen_white2d_c",   (DL_FUNC) &_ambient_gen_white2d_c,    4},
-    {"_ambient_gen_white3d_c",   (DL_FUNC) &_ambient_gen_white3d_c,    5},
-    {"_ambient_gen_white4d_c",   (DL_FUNC) &_ambient_gen_white4d_c,    6},
-    {"_ambient_gen_worley2d_c",  (DL_FUNC) &_ambient_gen_worley2d_c,   8},
-    {"_ambient_gen_worley3d_c",  (DL_FUNC) &_ambient_gen_worley3d_c,   9},
-    {"_ambient_perlin_2d_c",     (DL_FUNC) &_ambient_perlin_2d_c,     11},
-    {"_ambient_perlin_3d_c",     (DL_FUNC) &_ambient_perlin_3d_c,     12},
-    {"_ambient_simplex_2d_c",    (DL_FUNC) &_ambient_simplex_2d_c,    10},
-    {"_ambient_simplex_3d_c",    (DL_FUNC) &_ambient_simplex_3d_c,    11},
-    {"_ambient_simplex_4d_c",    (DL_FUNC) &_ambient_simplex_4d_c,    12},
-    {"_ambient_value_2d_c",      (DL_FUNC) &_ambient_value_2d_c,      11},
-    {"_ambient_value_3d_c",      (DL_FUNC) &_ambient_value_3d_c,      12},
-    {"_ambient_white_2d_c",      (DL_FUNC) &_ambient_white_2d_c,       6},
-    {"_ambient_white_3d_c",      (DL_FUNC) &_ambient_white_3d_c,       7},
-    {"_ambient_white_4d_c",      (DL_FUNC) &_ambient_white_4d_c,       8},
-    {"_ambient_worley_2d_c",     (DL_FUNC) &_ambient_worley_2d_c,     14},
-    {"_ambient_worley_3d_c",     (DL_FUNC) &_ambient_worley_3d_c,     15},
+    {"_ambient_blue_noise_c",                (DL_FUNC) &_ambient_blue_noise_c,                 3},
+    {"_ambient_blue_tiled_c",                (DL_FUNC) &_ambient_blue_tiled_c,                 5},
+    {"_ambient_cubic_2d_c",                  (DL_FUNC) &_ambient_cubic_2d_c,                  12},
+    {"_ambient_cubic_3d_c",                  (DL_FUNC) &_ambient_cubic_3d_c,                  13},
+    {"_ambient_curl_c",                      (DL_FUNC) &_ambient_curl_c,                      11},
+    {"_ambient_fracture_c",                  (DL_FUNC) &_ambient_fracture_c,                  15},
+    {"_ambient_gen_blue_c",                  (DL_FUNC) &_ambient_gen_blue_c,                   6},
+    {"_ambient_gen_cubic2d_c",               (DL_FUNC) &_ambient_gen_cubic2d_c,                7},
+    {"_ambient_gen_cubic3d_c",               (DL_FUNC) &_ambient_gen_cubic3d_c,                8},
+    {"_ambient_gen_perlin2d_c",              (DL_FUNC) &_ambient_gen_perlin2d_c,               8},
+    {"_ambient_gen_perlin3d_c",              (DL_FUNC) &_ambient_gen_perlin3d_c,               9},
+    {"_ambient_gen_simplex2d_c",             (DL_FUNC) &_ambient_gen_simplex2d_c,              7},
+    {"_ambient_gen_simplex3d_c",             (DL_FUNC) &_ambient_gen_simplex3d_c,              8},
+    {"_ambient_gen_simplex4d_c",             (DL_FUNC) &_ambient_gen_simplex4d_c,              9},
+    {"_ambient_gen_value2d_c",               (DL_FUNC) &_ambient_gen_value2d_c,                8},
+    {"_ambient_gen_value3d_c",               (DL_FUNC) &_ambient_gen_value3d_c,                9},
+    {"_ambient_gen_white2d_c",               (DL_FUNC) &_ambient_gen_white2d_c,                7},
+    {"_ambient_gen_white3d_c",               (DL_FUNC) &_ambient_gen_white3d_c,                8},
+    {"_ambient_gen_white4d_c",               (DL_FUNC) &_ambient_gen_white4d_c,                9},
+    {"_ambient_gen_worley2d_c",              (DL_FUNC) &_ambient_gen_worley2d_c,              11},
+    {"_ambient_gen_worley3d_c",              (DL_FUNC) &_ambient_gen_worley3d_c,              12},
+    {"_ambient_gradient_c",                  (DL_FUNC) &_ambient_gradient_c,                  13},
+    {"_ambient_grid_axis_c",                 (DL_FUNC) &_ambient_grid_axis_c,                  3},
+    {"_ambient_noise_file_c",                (DL_FUNC) &_ambient_noise_file_c,                 2},
+    {"_ambient_noise_handle_c",              (DL_FUNC) &_ambient_noise_handle_c,              16},
+    {"_ambient_noise_handle_eval_c",         (DL_FUNC) &_ambient_noise_handle_eval_c,          5},
+    {"_ambient_noise_lazy_c",                (DL_FUNC) &_ambient_noise_lazy_c,                 1},
+    {"_ambient_noise_progressive_c",         (DL_FUNC) &_ambient_noise_progressive_c,          1},
+    {"_ambient_noise_progressive_octaves_c", (DL_FUNC) &_ambient_noise_progressive_octaves_c,  1},
+    {"_ambient_noise_progressive_refine_c",  (DL_FUNC) &_ambient_noise_progressive_refine_c,   2},
+    {"_ambient_noise_pyramid_c",             (DL_FUNC) &_ambient_noise_pyramid_c,              2},
+    {"_ambient_noise_read_c",                (DL_FUNC) &_ambient_noise_read_c,                 1},
+    {"_ambient_noise_settings_key_c",        (DL_FUNC) &_ambient_noise_settings_key_c,         1},
+    {"_ambient_noise_tile_c",                (DL_FUNC) &_ambient_noise_tile_c,                 6},
+    {"_ambient_noise_tiles_c",               (DL_FUNC) &_ambient_noise_tiles_c,                3},
+    {"_ambient_noise_tiles_key_c",           (DL_FUNC) &_ambient_noise_tiles_key_c,            1},
+    {"_ambient_perlin_2d_c",                 (DL_FUNC) &_ambient_perlin_2d_c,                 13},
+    {"_ambient_perlin_3d_c",                 (DL_FUNC) &_ambient_perlin_3d_c,                 14},
+    {"_ambient_pool_shutdown_c",             (DL_FUNC) &_ambient_pool_shutdown_c,              0},
+    {"_ambient_simplex_2d_c",                (DL_FUNC) &_ambient_simplex_2d_c,                12},
+    {"_ambient_simplex_3d_c",                (DL_FUNC) &_ambient_simplex_3d_c,                13},
+    {"_ambient_simplex_4d_c",                (DL_FUNC) &_ambient_simplex_4d_c,                14},
+    {"_ambient_value_2d_c",                  (DL_FUNC) &_ambient_value_2d_c,                  13},
+    {"_ambient_value_3d_c",                  (DL_FUNC) &_ambient_value_3d_c,                  14},
+    {"_ambient_white_2d_c",                  (DL_FUNC) &_ambient_white_2d_c,                   8},
+    {"_ambient_white_3d_c",                  (DL_FUNC) &_ambient_white_3d_c,                   9},
+    {"_ambient_white_4d_c",                  (DL_FUNC) &_ambient_white_4d_c,                  10},
+    {"_ambient_worley_2d_c",                 (DL_FUNC) &_ambient_worley_2d_c,                 16},
+    {"_ambient_worley_3d_c",                 (DL_FUNC) &_ambient_worley_3d_c,                 17},
     {NULL, NULL, 0}
 };
 }
 
+void init_grid_axis(DllInfo* dll);
+void init_lazy_noise(DllInfo* dll);
+void init_mapped_noise(DllInfo* dll);
 extern "C" attribute_visible void R_init_ambient(DllInfo* dll){
   R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
   R_useDynamicSymbols(dll, FALSE);
+  init_grid_axis(dll);
+  init_lazy_noise(dll);
+  init_mapped_noise(dll);
   R_forceSymbols(dll, TRUE);
 }
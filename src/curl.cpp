@@ -0,0 +1,142 @@
+#include <cpp11/doubles.hpp>
+#include <cpp11/integers.hpp>
+#include <cpp11/list.hpp>
+#include <vector>
+#include "FastNoise.h"
+#include "fractal.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "parallel.h"
+
+// A noise field for curl: one generator per octave, all sharing the octave
+// frequencies and gains but with their own seeds
+template <typename T>
+struct CurlField {
+  std::vector< FastNoiseT<T> > octaves;
+};
+
+template <typename T>
+inline T noise_deriv(const FastNoiseT<T>& generator, int dims, const double* p, T* deriv) {
+  if (dims == 2) return generator.GetNoiseDeriv((T) p[0], (T) p[1], deriv);
+  return generator.GetNoiseDeriv((T) p[0], (T) p[1], (T) p[2], deriv);
+}
+
+// Partial derivatives of a (fractal) field at a point given in `D` dimensions
+template <int D, typename T>
+void field_deriv(const CurlField<T>& field, const double* gain, const FractalArgs& fractal, const double* p, double* deriv) {
+  double acc = 0.0, w = 1.0;
+  double dw[D] = {};
+  for (int d = 0; d < D; ++d) deriv[d] = 0.0;
+  for (size_t o = 0; o < field.octaves.size(); ++o) {
+    T dn[3];
+    T n = noise_deriv(field.octaves[o], D, p, dn);
+    double dnd[D];
+    for (int d = 0; d < D; ++d) dnd[d] = dn[d];
+    fractal_octave_deriv<D>(fractal, gain[o], n, dnd, acc, deriv, w, dw);
+  }
+  fractal_finalise_deriv<D>(fractal, acc, deriv);
+}
+
+// The curl of the 2D field (F1, F2) in the xy plane is (-dF2/dy, dF1/dx). The
+// field may be evaluated in 3D at a fixed z. If both fields are the same it is
+// only evaluated once
+template <int D, typename T>
+void curl_2d(double* vx, double* vy, int n, const PointAxis* coords, const std::vector< CurlField<T> >& fields, bool shared, const double* gain, const FractalArgs& fractal, int threads) {
+  parallel_for(n, threads, [&](int begin, int end) {
+    double p[D], d1[D], d2[D];
+    for (int i = begin; i < end; ++i) {
+      for (int d = 0; d < D; ++d) p[d] = coords[d][i];
+      field_deriv<D>(fields[0], gain, fractal, p, d1);
+      if (shared) {
+        vx[i] = -d1[1];
+      } else {
+        field_deriv<D>(fields[1], gain, fractal, p, d2);
+        vx[i] = -d2[1];
+      }
+      vy[i] = d1[0];
+    }
+  });
+}
+
+// The curl of the 3D field (F1, F2, F3)
+template <typename T>
+void curl_3d(double* vx, double* vy, double* vz, int n, const PointAxis* coords, const std::vector< CurlField<T> >& fields, const double* gain, const FractalArgs& fractal, int threads) {
+  parallel_for(n, threads, [&](int begin, int end) {
+    double p[3], d1[3], d2[3], d3[3];
+    for (int i = begin; i < end; ++i) {
+      for (int d = 0; d < 3; ++d) p[d] = coords[d][i];
+      field_deriv<3>(fields[0], gain, fractal, p, d1);
+      field_deriv<3>(fields[1], gain, fractal, p, d2);
+      field_deriv<3>(fields[2], gain, fractal, p, d3);
+      vx[i] = d3[1] - d2[2];
+      vy[i] = d1[2] - d3[0];
+      vz[i] = d2[0] - d1[1];
+    }
+  });
+}
+
+template <typename T>
+void curl_fields(double* vx, double* vy, double* vz, int curl_dims, int n, int dims, const PointAxis* coords, const std::vector< std::vector<FastNoise> >& generators, const double* gain, const FractalArgs& fractal, int threads) {
+  std::vector< CurlField<T> > fields(generators.size());
+  for (size_t f = 0; f < generators.size(); ++f) {
+    for (size_t o = 0; o < generators[f].size(); ++o) {
+      fields[f].octaves.emplace_back(generators[f][o]);
+    }
+  }
+  if (curl_dims == 3) {
+    curl_3d<T>(vx, vy, vz, n, coords, fields, gain, fractal, threads);
+    return;
+  }
+  bool shared = fields.size() == 1;
+  if (dims == 2) {
+    curl_2d<2, T>(vx, vy, n, coords, fields, shared, gain, fractal, threads);
+  } else {
+    curl_2d<3, T>(vx, vy, n, coords, fields, shared, gain, fractal, threads);
+  }
+}
+
+[[cpp11::register]]
+cpp11::writable::list curl_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::list seeds, cpp11::doubles gain, int interp, cpp11::doubles fractal_args, int curl_dims, int threads, bool single) {
+  int dims = coords.size();
+  if (dims < 2 || dims > 3) cpp11::stop("Curl can only be calculated for 2D and 3D fields");
+  if (curl_dims == 3 && dims != 3) cpp11::stop("3D curl requires a 3D field");
+  if (type != PerlinGen && type != SimplexGen && type != ValueGen && type != CubicGen) {
+    cpp11::stop("Analytic derivatives are only available for perlin, simplex, value, and cubic noise");
+  }
+  int n_octaves = freq.size();
+  if (gain.size() != n_octaves) cpp11::stop("frequency and gain must have one value per octave");
+
+  std::vector<cpp11::doubles> axes;
+  PointAxis c[3];
+  for (int d = 0; d < dims; ++d) {
+    axes.push_back(cpp11::doubles(coords[d]));
+    c[d] = point_axis(axes[d]);
+  }
+  int n = axes[0].size();
+
+  GeneratorArgs args = {interp, 0, 0, cpp11::integers(), 0.0};
+  FractalArgs frac = {(Fractal) fractal, fractal_args[0], fractal_args[1]};
+  std::vector< std::vector<FastNoise> > generators(seeds.size());
+  for (int f = 0; f < seeds.size(); ++f) {
+    cpp11::integers seed(seeds[f]);
+    if (seed.size() != n_octaves) cpp11::stop("seeds must have one value per octave");
+    for (int o = 0; o < n_octaves; ++o) {
+      generators[f].push_back(generator_c((Generator) type, seed[o], freq[o], args));
+    }
+  }
+
+  cpp11::writable::doubles vx(n);
+  cpp11::writable::doubles vy(n);
+  cpp11::writable::doubles vz(curl_dims == 3 ? n : 0);
+  double* v[] = {REAL(vx.data()), REAL(vy.data()), REAL(vz.data())};
+  if (single) {
+    curl_fields<float>(v[0], v[1], v[2], curl_dims, n, dims, c, generators, REAL(gain), frac, threads);
+  } else {
+    curl_fields<double>(v[0], v[1], v[2], curl_dims, n, dims, c, generators, REAL(gain), frac, threads);
+  }
+  cpp11::writable::list res;
+  res.push_back(vx);
+  res.push_back(vy);
+  if (curl_dims == 3) res.push_back(vz);
+  return res;
+}
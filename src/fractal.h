@@ -0,0 +1,70 @@
+#ifndef AMBIENT_FRACTAL_H
+#define AMBIENT_FRACTAL_H
+
+#include <cmath>
+
+// The fractal functions of fracture() that can be combined natively, in the
+// order they are identified from R
+enum Fractal { FbmFractal, BillowFractal, ClampedFractal, RidgedFractal };
+
+// The arguments of the fractal function. `a` and `b` are `min` and `max` for
+// clamped() and `offset` and `gain` for ridged()
+struct FractalArgs {
+  Fractal type;
+  double a;
+  double b;
+};
+
+// Combines an octave of noise `n` with partial derivatives `dn` into the
+// accumulated value `acc` and derivatives `dacc`, following the chain rule
+// through the fractal function. `w` and `dw` hold the weight ridged() carries
+// between octaves and must start at 1 and 0.
+template <int D>
+inline void fractal_octave_deriv(const FractalArgs& fractal, double gain, double n, const double* dn, double& acc, double* dacc, double& w, double* dw) {
+  double sign = n < 0.0 ? -1.0 : 1.0;
+  switch (fractal.type) {
+  case FbmFractal:
+    acc += n * gain;
+    for (int d = 0; d < D; ++d) dacc[d] += dn[d] * gain;
+    break;
+  case BillowFractal:
+    acc += (2.0 * std::fabs(n) - 1.0) * gain;
+    for (int d = 0; d < D; ++d) dacc[d] += 2.0 * sign * dn[d] * gain;
+    break;
+  case ClampedFractal: {
+    bool inside = n > fractal.a && n < fractal.b;
+    acc += (n < fractal.a ? fractal.a : n > fractal.b ? fractal.b : n) * gain;
+    if (inside) {
+      for (int d = 0; d < D; ++d) dacc[d] += dn[d] * gain;
+    }
+    break;
+  }
+  case RidgedFractal: {
+    double s = fractal.a - std::fabs(n);
+    double sig = s * s * w;
+    double next = sig * fractal.b;
+    bool inside = next > 0.0 && next < 1.0;
+    for (int d = 0; d < D; ++d) {
+      double dsig = -2.0 * s * sign * dn[d] * w + s * s * dw[d];
+      dacc[d] += dsig * gain;
+      dw[d] = inside ? dsig * fractal.b : 0.0;
+    }
+    w = next < 0.0 ? 0.0 : next > 1.0 ? 1.0 : next;
+    acc += sig * gain;
+    break;
+  }
+  }
+}
+
+// Applies the finalising step of the fractal function
+template <int D>
+inline void fractal_finalise_deriv(const FractalArgs& fractal, double& acc, double* dacc) {
+  if (fractal.type == BillowFractal) {
+    acc = acc + 0.5;
+  } else if (fractal.type == RidgedFractal) {
+    acc = acc * 1.25 - 1.0;
+    for (int d = 0; d < D; ++d) dacc[d] *= 1.25;
+  }
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include <cpp11/doubles.hpp>
+#include <cpp11/integers.hpp>
+#include <cpp11/list.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "FastNoise.h"
+#include "fractal.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "parallel.h"
+#include "spatial.h"
+
+// Evaluates every octave of a fractal for chunks of points, accumulating into
+// a single buffer per chunk. The accumulation is done in double precision in
+// the same order as the R implementation of the fractal functions so the
+// result matches calling the generator once per octave from R. The weight
+// ridged() carries from one octave to the next is kept per point alongside the
+// accumulator.
+template <int D, typename T>
+void fracture_points(double* out, int n, const PointAxis* coords, const std::vector< FastNoiseT<T> >& octaves, const double* gain, const FractalArgs& fractal, const std::vector<int>& order, int threads) {
+  const int* ord = order.empty() ? nullptr : order.data();
+  parallel_for(n, threads, [&](int begin, int end) {
+    const int batch_size = 256;
+    T buffer[D][batch_size];
+    T res[batch_size];
+    double acc[batch_size];
+    double weight[batch_size];
+    const T* chunk[D];
+    for (int d = 0; d < D; ++d) {
+      chunk[d] = buffer[d];
+    }
+    for (int b = begin; b < end; b += batch_size) {
+      int m = std::min(batch_size, end - b);
+      for (int d = 0; d < D; ++d) {
+        if (ord == nullptr) {
+          coords[d].fill(b, m, buffer[d]);
+        } else {
+          for (int i = 0; i < m; ++i) {
+            buffer[d][i] = (T) coords[d][ord[b + i]];
+          }
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        acc[i] = 0.0;
+        weight[i] = 1.0;
+      }
+      for (size_t o = 0; o < octaves.size(); ++o) {
+        octaves[o].GetNoiseBatch(D, chunk, res, m);
+        double g = gain[o];
+        switch (fractal.type) {
+        case FbmFractal:
+          for (int i = 0; i < m; ++i) acc[i] = acc[i] + (double) res[i] * g;
+          break;
+        case BillowFractal:
+          for (int i = 0; i < m; ++i) acc[i] = acc[i] + (2.0 * std::fabs((double) res[i]) - 1.0) * g;
+          break;
+        case ClampedFractal:
+          for (int i = 0; i < m; ++i) {
+            double v = res[i];
+            if (v < fractal.a) v = fractal.a;
+            if (v > fractal.b) v = fractal.b;
+            acc[i] = acc[i] + v * g;
+          }
+          break;
+        case RidgedFractal:
+          for (int i = 0; i < m; ++i) {
+            double sig = fractal.a - std::fabs((double) res[i]);
+            sig = sig * sig * weight[i];
+            double w = sig * fractal.b;
+            if (w < 0.0) w = 0.0;
+            if (w > 1.0) w = 1.0;
+            weight[i] = w;
+            acc[i] = acc[i] + sig * g;
+          }
+          break;
+        }
+      }
+      if (fractal.type == BillowFractal) {
+        for (int i = 0; i < m; ++i) acc[i] = acc[i] + 0.5;
+      } else if (fractal.type == RidgedFractal) {
+        for (int i = 0; i < m; ++i) acc[i] = acc[i] * 1.25 - 1.0;
+      }
+      for (int i = 0; i < m; ++i) {
+        out[ord == nullptr ? b + i : ord[b + i]] = acc[i];
+      }
+    }
+  });
+}
+
+template <typename T>
+void fracture_dims(double* out, int n, int dims, const PointAxis* coords, const std::vector<FastNoise>& generators, const double* gain, const FractalArgs& fractal, const std::vector<int>& order, int threads) {
+  std::vector< FastNoiseT<T> > octaves(generators.begin(), generators.end());
+  switch (dims) {
+  case 2: fracture_points<2, T>(out, n, coords, octaves, gain, fractal, order, threads); break;
+  case 3: fracture_points<3, T>(out, n, coords, octaves, gain, fractal, order, threads); break;
+  default: fracture_points<4, T>(out, n, coords, octaves, gain, fractal, order, threads);
+  }
+}
+
+[[cpp11::register]]
+cpp11::writable::doubles fracture_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::integers seed, cpp11::doubles gain, int interp, int dist, int value, cpp11::integers dist2ind, double jitter, cpp11::doubles fractal_args, int threads, bool presort, bool single) {
+  int dims = coords.size();
+  if (dims < 2 || dims > 4) cpp11::stop("Fractals can only be evaluated in 2 to 4 dimensions");
+  if (dims == 4 && type != SimplexGen && type != WhiteGen) cpp11::stop("4D noise is only available for simplex and white noise");
+  int n_octaves = freq.size();
+  if (seed.size() != n_octaves || gain.size() != n_octaves) cpp11::stop("frequency, seed, and gain must have one value per octave");
+
+  std::vector<cpp11::doubles> axes;
+  PointAxis c[4];
+  for (int d = 0; d < dims; ++d) {
+    axes.push_back(cpp11::doubles(coords[d]));
+    c[d] = point_axis(axes[d]);
+  }
+  int n = axes[0].size();
+  cpp11::writable::doubles noise(n);
+  double* out = REAL(noise.data());
+
+  GeneratorArgs args = {interp, dist, value, dist2ind, jitter};
+  FractalArgs frac = {(Fractal) fractal, fractal_args[0], fractal_args[1]};
+  std::vector<FastNoise> generators;
+  for (int o = 0; o < n_octaves; ++o) {
+    generators.push_back(generator_c((Generator) type, seed[o], freq[o], args));
+  }
+
+  // Octaves share the spatial order of the first so that neighbouring points
+  // stay together for all of them
+  std::vector<int> order;
+  if (presort && n_octaves > 0) {
+    order = spatial_order(n, freq[0], dims, c);
+  }
+  if (single) {
+    fracture_dims<float>(out, n, dims, c, generators, REAL(gain), frac, order, threads);
+  } else {
+    fracture_dims<double>(out, n, dims, c, generators, REAL(gain), frac, order, threads);
+  }
+  return noise;
+}
@@ -0,0 +1,77 @@
+#ifndef AMBIENT_GENERATOR_H
+#define AMBIENT_GENERATOR_H
+
+#include <cpp11/integers.hpp>
+#include <cstring>
+#include "FastNoise.h"
+
+// How seeds are expanded into permutation tables, given as either 'legacy'
+// (default) or 'splitmix'
+inline FastNoise::SeedMode seed_mode(SEXP option) {
+  if (option == R_NilValue) return FastNoise::SeedLegacy;
+  if (TYPEOF(option) == STRSXP && Rf_xlength(option) == 1) {
+    const char* mode = CHAR(STRING_ELT(option, 0));
+    if (std::strcmp(mode, "legacy") == 0) return FastNoise::SeedLegacy;
+    if (std::strcmp(mode, "splitmix") == 0) return FastNoise::SeedSplitMix;
+  }
+  cpp11::stop("The `ambient.seeding` option must be either 'legacy' or 'splitmix'");
+}
+
+// The seeding given by the `ambient.seeding` option
+inline FastNoise::SeedMode seed_mode() {
+  return seed_mode(Rf_GetOption1(Rf_install("ambient.seeding")));
+}
+
+// Generator factories shared between the noise types and the code combining
+// them. Each is defined alongside the noise it sets up.
+FastNoise perlin_c(int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
+FastNoise value_c(int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
+FastNoise cubic_c(int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
+FastNoise simplex_c(int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp);
+FastNoise worley_c(int seed, double freq, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp);
+FastNoise white_c(int seed, double freq, int pertube, double pertube_amp);
+
+// The gen_*() functions in the order they are identified from R
+enum Generator { PerlinGen, SimplexGen, ValueGen, CubicGen, WorleyGen, WhiteGen };
+
+// Settings of a gen_*() call beyond frequency and seed
+struct GeneratorArgs {
+  int interp;
+  int dist;
+  int value;
+  cpp11::integers dist2ind;
+  double jitter;
+};
+
+// The generator evaluated by a gen_*() call. gen_white() ignores the frequency
+// so the generator does so as well
+inline FastNoise generator_c(Generator type, int seed, double freq, const GeneratorArgs& args) {
+  switch (type) {
+  case PerlinGen: return perlin_c(seed, freq, args.interp, 0, 0, 0.0, 0.0, 0, 0.0);
+  case SimplexGen: return simplex_c(seed, freq, 0, 0, 0.0, 0.0, 0, 0.0);
+  case ValueGen: return value_c(seed, freq, args.interp, 0, 0, 0.0, 0.0, 0, 0.0);
+  case CubicGen: return cubic_c(seed, freq, 0, 0, 0.0, 0.0, 0, 0.0);
+  case WorleyGen: return worley_c(seed, freq, 0, 0, 0.0, 0.0, args.dist, args.value, args.dist2ind, args.jitter, 0, 0.0);
+  case WhiteGen: break;
+  }
+  FastNoise white = white_c(seed, 1.0, 0, 0.0);
+  white.SetNoiseType(FastNoise::WhiteNoise);
+  return white;
+}
+
+// The generator of a noise_*() call with all its settings
+inline FastNoise noise_generator_c(Generator type, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp) {
+  switch (type) {
+  case PerlinGen: return perlin_c(seed, freq, interp, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
+  case SimplexGen: return simplex_c(seed, freq, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
+  case ValueGen: return value_c(seed, freq, interp, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
+  case CubicGen: return cubic_c(seed, freq, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
+  case WorleyGen: return worley_c(seed, freq, fractal, octaves, lacunarity, gain, dist, value, dist2ind, jitter, pertube, pertube_amp);
+  case WhiteGen: break;
+  }
+  FastNoise white = white_c(seed, freq, pertube, pertube_amp);
+  white.SetNoiseType(FastNoise::WhiteNoise);
+  return white;
+}
+
+#endif
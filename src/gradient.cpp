@@ -0,0 +1,92 @@
+#include <cpp11/doubles.hpp>
+#include <cpp11/integers.hpp>
+#include <cpp11/list.hpp>
+#include <vector>
+#include "FastNoise.h"
+#include "FastNoiseDual.h"
+#include "fractal.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "parallel.h"
+
+typedef FastNoiseT<FastNoiseDual> FastNoiseGrad;
+
+// The noise of a generator at a point of dual numbers, evaluated the same way
+// as the gen_*() functions evaluate it
+template <int D>
+inline FastNoiseDual dual_noise(const FastNoiseGrad& generator, Generator type, const FastNoiseDual* p) {
+  switch (D) {
+  case 2: return generator.GetNoise(p[0], p[1]);
+  case 3: return generator.GetNoise(p[0], p[1], p[2]);
+  }
+  if (type == WhiteGen) return generator.GetWhiteNoise(p[0], p[1], p[2], p[3]);
+  return generator.GetSimplex(p[0], p[1], p[2], p[3]);
+}
+
+// The value and exact gradient of a (fractal) generator. Every coordinate is
+// seeded as an input variable so the partial derivatives of each octave come
+// out of the dual number arithmetic and are combined by the chain rule of the
+// fractal
+template <int D>
+void gradient_points(double* const* out, int n, const PointAxis* coords, const std::vector<FastNoiseGrad>& octaves, Generator type, const double* gain, const FractalArgs& fractal, int threads) {
+  parallel_for(n, threads, [&](int begin, int end) {
+    FastNoiseDual p[D];
+    double dn[D], deriv[D], dw[D];
+    for (int i = begin; i < end; ++i) {
+      for (int d = 0; d < D; ++d) {
+        p[d] = FastNoiseDual::Variable(coords[d][i], d);
+        deriv[d] = 0.0;
+        dw[d] = 0.0;
+      }
+      double acc = 0.0, w = 1.0;
+      for (size_t o = 0; o < octaves.size(); ++o) {
+        FastNoiseDual noise = dual_noise<D>(octaves[o], type, p);
+        for (int d = 0; d < D; ++d) dn[d] = noise.d[d];
+        fractal_octave_deriv<D>(fractal, gain[o], noise.v, dn, acc, deriv, w, dw);
+      }
+      fractal_finalise_deriv<D>(fractal, acc, deriv);
+      out[0][i] = acc;
+      for (int d = 0; d < D; ++d) out[d + 1][i] = deriv[d];
+    }
+  });
+}
+
+[[cpp11::register]]
+cpp11::writable::list gradient_c(int type, int fractal, cpp11::list coords, cpp11::doubles freq, cpp11::integers seed, cpp11::doubles gain, int interp, int dist, int value, cpp11::integers dist2ind, double jitter, cpp11::doubles fractal_args, int threads) {
+  int dims = coords.size();
+  if (dims < 2 || dims > 4) cpp11::stop("Gradients can only be calculated in 2 to 4 dimensions");
+  if (dims == 4 && type != SimplexGen && type != WhiteGen) cpp11::stop("4D noise is only available for simplex and white noise");
+  int n_octaves = freq.size();
+  if (seed.size() != n_octaves || gain.size() != n_octaves) cpp11::stop("frequency, seed, and gain must have one value per octave");
+
+  std::vector<cpp11::doubles> axes;
+  PointAxis c[4];
+  for (int d = 0; d < dims; ++d) {
+    axes.push_back(cpp11::doubles(coords[d]));
+    c[d] = point_axis(axes[d]);
+  }
+  int n = axes[0].size();
+
+  GeneratorArgs args = {interp, dist, value, dist2ind, jitter};
+  FractalArgs frac = {(Fractal) fractal, fractal_args[0], fractal_args[1]};
+  std::vector<FastNoiseGrad> octaves;
+  for (int o = 0; o < n_octaves; ++o) {
+    octaves.emplace_back(generator_c((Generator) type, seed[o], freq[o], args));
+  }
+
+  // The value followed by the partial derivative along each dimension
+  std::vector<cpp11::writable::doubles> res;
+  double* out[5];
+  for (int d = 0; d <= dims; ++d) {
+    res.push_back(cpp11::writable::doubles(n));
+    out[d] = REAL(res[d].data());
+  }
+  switch (dims) {
+  case 2: gradient_points<2>(out, n, c, octaves, (Generator) type, REAL(gain), frac, threads); break;
+  case 3: gradient_points<3>(out, n, c, octaves, (Generator) type, REAL(gain), frac, threads); break;
+  default: gradient_points<4>(out, n, c, octaves, (Generator) type, REAL(gain), frac, threads);
+  }
+  cpp11::writable::list gradient;
+  for (int d = 0; d <= dims; ++d) gradient.push_back(res[d]);
+  return gradient;
+}
@@ -0,0 +1,224 @@
+#include <cpp11/R.hpp>
+#include <cpp11/protect.hpp>
+#include <R_ext/Altrep.h>
+#include <R_ext/Rdynload.h>
+#include <algorithm>
+#include "grid_axis.h"
+
+// Lazy long_grid() axes. The axis values are repeated `each` times in turn and
+// recycled to the length of the grid, like rep(values, each = each,
+// length.out = length). data1 holds list(values, c(each, length)) and data2
+// the materialised vector once something asks for a pointer to the data.
+// There is a class for double and for integer axes
+static R_altrep_class_t grid_axis_real;
+static R_altrep_class_t grid_axis_integer;
+
+inline double* axis_data(SEXP x, double*) { return REAL(x); }
+inline int* axis_data(SEXP x, int*) { return INTEGER(x); }
+inline bool axis_is_na(double v) { return ISNAN(v); }
+inline bool axis_is_na(int v) { return v == NA_INTEGER; }
+
+inline SEXP axis_values(SEXP x) {
+  return VECTOR_ELT(R_altrep_data1(x), 0);
+}
+inline R_xlen_t axis_each(SEXP x) {
+  return (R_xlen_t) REAL(VECTOR_ELT(R_altrep_data1(x), 1))[0];
+}
+inline R_xlen_t axis_length(SEXP x) {
+  return (R_xlen_t) REAL(VECTOR_ELT(R_altrep_data1(x), 1))[1];
+}
+
+static SEXP new_grid_axis(SEXP values, R_xlen_t each, R_xlen_t length) {
+  MARK_NOT_MUTABLE(values);
+  SEXP params = PROTECT(Rf_allocVector(REALSXP, 2));
+  REAL(params)[0] = each;
+  REAL(params)[1] = length;
+  SEXP state = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(state, 0, values);
+  SET_VECTOR_ELT(state, 1, params);
+  R_altrep_class_t cls = TYPEOF(values) == INTSXP ? grid_axis_integer : grid_axis_real;
+  SEXP axis = R_new_altrep(cls, state, R_NilValue);
+  UNPROTECT(2);
+  return axis;
+}
+
+template <typename T>
+R_xlen_t axis_get_region(SEXP x, R_xlen_t i, R_xlen_t n, T* buf) {
+  R_xlen_t length = axis_length(x);
+  n = std::min(n, length - i);
+  if (n <= 0) return 0;
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) {
+    const T* data = axis_data(materialised, (T*) nullptr);
+    std::copy(data + i, data + i + n, buf);
+    return n;
+  }
+  SEXP values = axis_values(x);
+  const T* v = axis_data(values, (T*) nullptr);
+  R_xlen_t n_values = Rf_xlength(values);
+  R_xlen_t each = axis_each(x);
+  R_xlen_t block = i / each;
+  R_xlen_t left = each - i % each;
+  for (R_xlen_t k = 0; k < n; ++block, left = each) {
+    R_xlen_t m = std::min(left, n - k);
+    std::fill(buf + k, buf + k + m, v[block % n_values]);
+    k += m;
+  }
+  return n;
+}
+
+template <typename T>
+T axis_elt(SEXP x, R_xlen_t i) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) return axis_data(materialised, (T*) nullptr)[i];
+  SEXP values = axis_values(x);
+  return axis_data(values, (T*) nullptr)[(i / axis_each(x)) % Rf_xlength(values)];
+}
+
+template <typename T, SEXPTYPE RTYPE>
+void* axis_dataptr(SEXP x, Rboolean) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised == R_NilValue) {
+    R_xlen_t length = axis_length(x);
+    materialised = PROTECT(Rf_allocVector(RTYPE, length));
+    axis_get_region<T>(x, 0, length, axis_data(materialised, (T*) nullptr));
+    R_set_altrep_data2(x, materialised);
+    UNPROTECT(1);
+  }
+  return axis_data(materialised, (T*) nullptr);
+}
+
+template <typename T>
+const void* axis_dataptr_or_null(SEXP x) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised == R_NilValue) return nullptr;
+  return axis_data(materialised, (T*) nullptr);
+}
+
+static R_xlen_t axis_length_method(SEXP x) {
+  return axis_length(x);
+}
+
+// Saved as the axis values and repetition so the grid stays lazy when it is
+// read back. Materialised axes may have been modified and are saved as
+// ordinary vectors
+static SEXP axis_serialized_state(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  return R_altrep_data1(x);
+}
+
+static SEXP axis_unserialize(SEXP, SEXP state) {
+  SEXP params = VECTOR_ELT(state, 1);
+  return new_grid_axis(VECTOR_ELT(state, 0), (R_xlen_t) REAL(params)[0], (R_xlen_t) REAL(params)[1]);
+}
+
+// Copies share the axis values until they are modified. Materialised axes are
+// copied as ordinary vectors
+static SEXP axis_duplicate(SEXP x, Rboolean) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  SEXP state = R_altrep_data1(x);
+  SEXP params = VECTOR_ELT(state, 1);
+  return new_grid_axis(VECTOR_ELT(state, 0), (R_xlen_t) REAL(params)[0], (R_xlen_t) REAL(params)[1]);
+}
+
+// Materialised axes may have been modified, so only the axis values are known
+// to be free of NA
+template <typename T>
+int axis_no_na(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) return 0;
+  SEXP values = axis_values(x);
+  const T* v = axis_data(values, (T*) nullptr);
+  for (R_xlen_t i = 0; i < Rf_xlength(values); ++i) {
+    if (axis_is_na(v[i])) return 0;
+  }
+  return 1;
+}
+
+static double axis_real_elt(SEXP x, R_xlen_t i) {
+  return axis_elt<double>(x, i);
+}
+
+static int axis_integer_elt(SEXP x, R_xlen_t i) {
+  return axis_elt<int>(x, i);
+}
+
+static R_xlen_t axis_real_get_region(SEXP x, R_xlen_t i, R_xlen_t n, double* buf) {
+  return axis_get_region<double>(x, i, n, buf);
+}
+
+static R_xlen_t axis_integer_get_region(SEXP x, R_xlen_t i, R_xlen_t n, int* buf) {
+  return axis_get_region<int>(x, i, n, buf);
+}
+
+// as.numeric() on an integer axis, as done by the gen_*() functions, gives a
+// lazy double axis. Materialised axes may have been modified and are coerced
+// as ordinary vectors
+static SEXP axis_integer_coerce(SEXP x, int type) {
+  if (type != REALSXP || R_altrep_data2(x) != R_NilValue) return nullptr;
+  SEXP values = PROTECT(Rf_coerceVector(axis_values(x), REALSXP));
+  SEXP axis = new_grid_axis(values, axis_each(x), axis_length(x));
+  UNPROTECT(1);
+  return axis;
+}
+
+PointAxis point_axis(SEXP x) {
+  PointAxis axis = {nullptr, nullptr, 0, 1};
+  if (ALTREP(x) && R_altrep_inherits(x, grid_axis_real) && R_altrep_data2(x) == R_NilValue) {
+    SEXP values = axis_values(x);
+    axis.values = REAL(values);
+    axis.n_values = Rf_xlength(values);
+    axis.each = axis_each(x);
+    return axis;
+  }
+  axis.data = REAL(x);
+  return axis;
+}
+
+[[cpp11::register]]
+SEXP grid_axis_c(SEXP values, double each, double length) {
+  if (TYPEOF(values) != REALSXP && TYPEOF(values) != INTSXP) {
+    cpp11::stop("Grid axes must be double or integer vectors");
+  }
+  R_xlen_t n = Rf_xlength(values);
+  if (n == 0 || each < 1) cpp11::stop("Grid axes can't be empty");
+  // The values are read directly by point_axis() so compact sequences and
+  // other ALTREP input is copied to an ordinary vector
+  if (ALTREP(values)) {
+    SEXP plain = PROTECT(Rf_allocVector(TYPEOF(values), n));
+    if (TYPEOF(values) == INTSXP) {
+      INTEGER_GET_REGION(values, 0, n, INTEGER(plain));
+    } else {
+      REAL_GET_REGION(values, 0, n, REAL(plain));
+    }
+    SEXP axis = new_grid_axis(plain, (R_xlen_t) each, (R_xlen_t) length);
+    UNPROTECT(1);
+    return axis;
+  }
+  return new_grid_axis(values, (R_xlen_t) each, (R_xlen_t) length);
+}
+
+[[cpp11::init]]
+void init_grid_axis(DllInfo* dll) {
+  grid_axis_real = R_make_altreal_class("grid_axis_real", "ambient", dll);
+  R_set_altrep_Length_method(grid_axis_real, axis_length_method);
+  R_set_altrep_Serialized_state_method(grid_axis_real, axis_serialized_state);
+  R_set_altrep_Unserialize_method(grid_axis_real, axis_unserialize);
+  R_set_altrep_Duplicate_method(grid_axis_real, axis_duplicate);
+  R_set_altvec_Dataptr_method(grid_axis_real, axis_dataptr<double, REALSXP>);
+  R_set_altvec_Dataptr_or_null_method(grid_axis_real, axis_dataptr_or_null<double>);
+  R_set_altreal_Elt_method(grid_axis_real, axis_real_elt);
+  R_set_altreal_Get_region_method(grid_axis_real, axis_real_get_region);
+  R_set_altreal_No_NA_method(grid_axis_real, axis_no_na<double>);
+
+  grid_axis_integer = R_make_altinteger_class("grid_axis_integer", "ambient", dll);
+  R_set_altrep_Length_method(grid_axis_integer, axis_length_method);
+  R_set_altrep_Serialized_state_method(grid_axis_integer, axis_serialized_state);
+  R_set_altrep_Unserialize_method(grid_axis_integer, axis_unserialize);
+  R_set_altrep_Duplicate_method(grid_axis_integer, axis_duplicate);
+  R_set_altrep_Coerce_method(grid_axis_integer, axis_integer_coerce);
+  R_set_altvec_Dataptr_method(grid_axis_integer, axis_dataptr<int, INTSXP>);
+  R_set_altvec_Dataptr_or_null_method(grid_axis_integer, axis_dataptr_or_null<int>);
+  R_set_altinteger_Elt_method(grid_axis_integer, axis_integer_elt);
+  R_set_altinteger_Get_region_method(grid_axis_integer, axis_integer_get_region);
+  R_set_altinteger_No_NA_method(grid_axis_integer, axis_no_na<int>);
+}
@@ -0,0 +1,11 @@
+#ifndef AMBIENT_GRID_AXIS_H
+#define AMBIENT_GRID_AXIS_H
+
+#include <cpp11/R.hpp>
+#include "point_axis.h"
+
+// The coordinates of a double vector. Lazy long_grid() axes are read through
+// their axis values without being materialised
+PointAxis point_axis(SEXP x);
+
+#endif
@@ -0,0 +1,138 @@
+#include <cpp11/doubles.hpp>
+#include <cpp11/external_pointer.hpp>
+#include <cpp11/integers.hpp>
+#include <algorithm>
+#include <vector>
+#include "FastNoise.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "noise.h"
+
+// A fully configured generator kept on the R side as an external pointer.
+// Evaluating it skips the argument checking and generator construction of the
+// gen_*() functions, which dominate when only a few points are evaluated per
+// call
+struct NoiseHandle {
+  FastNoise noise;
+  FastNoiseT<float> noise_single;
+  Generator type;
+  int pertube;
+  int threads;
+  bool single;
+};
+
+// Perturbation moves the coordinates so each batch is copied before it is
+// perturbed and evaluated
+template <int D, typename T>
+void handle_points(double* out, int n, const PointAxis* coords, const FastNoiseT<T>& generator, int pertube, int threads) {
+  std::vector<int> order;
+  if (pertube == 0) {
+    noise_points<D>(out, n, coords, generator, order, threads);
+    return;
+  }
+  parallel_batches<D, T>(n, threads, order, coords, out, [&](const T* const* c, T* res, int m) {
+    const int batch_size = 256;
+    T buffer[D][batch_size];
+    T* chunk[D];
+    for (int d = 0; d < D; ++d) {
+      chunk[d] = buffer[d];
+    }
+    for (int b = 0; b < m; b += batch_size) {
+      int k = std::min(batch_size, m - b);
+      for (int d = 0; d < D; ++d) {
+        std::copy(c[d] + b, c[d] + b + k, buffer[d]);
+      }
+      generator.GradientPerturbBatch(D, chunk, k, pertube == 2);
+      generator.GetNoiseBatch(D, chunk, res + b, k);
+    }
+  });
+}
+
+template <typename T>
+void handle_eval(double* out, int n, int dims, const PointAxis* coords, const FastNoiseT<T>& generator, int pertube, int threads) {
+  switch (dims) {
+  case 2: handle_points<2>(out, n, coords, generator, pertube, threads); break;
+  case 3: handle_points<3>(out, n, coords, generator, pertube, threads); break;
+  // There is no 4D perturbation
+  default: handle_points<4>(out, n, coords, generator, 0, threads);
+  }
+}
+
+// Coordinates are used in place when they are doubles of the full length.
+// Other numeric input is converted and length 1 input recycled in `buffer`
+inline PointAxis buffer_axis(const std::vector<double>& buffer) {
+  PointAxis axis = {buffer.data(), nullptr, 0, 1};
+  return axis;
+}
+inline PointAxis handle_coords(SEXP x, R_xlen_t n, std::vector<double>& buffer) {
+  if (TYPEOF(x) == REALSXP && Rf_xlength(x) == n) return point_axis(x);
+  if (TYPEOF(x) != REALSXP && TYPEOF(x) != INTSXP && TYPEOF(x) != LGLSXP) {
+    cpp11::stop("Coordinates must be numeric");
+  }
+  R_xlen_t length = Rf_xlength(x);
+  if (length != n && length != 1) {
+    cpp11::stop("Coordinates must either be of length 1, or match the total length");
+  }
+  buffer.resize(n);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    R_xlen_t j = length == 1 ? 0 : i;
+    if (TYPEOF(x) == REALSXP) {
+      buffer[i] = REAL(x)[j];
+    } else {
+      int value = TYPEOF(x) == INTSXP ? INTEGER(x)[j] : LOGICAL(x)[j];
+      buffer[i] = value == NA_INTEGER ? NA_REAL : value;
+    }
+  }
+  return buffer_axis(buffer);
+}
+
+[[cpp11::register]]
+SEXP noise_handle_c(int type, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int dist, int value, cpp11::integers dist2ind, double jitter, int pertube, double pertube_amp, int threads, bool single) {
+  if (type < PerlinGen || type > WhiteGen) cpp11::stop("Unknown generator type");
+  FastNoise noise = noise_generator_c((Generator) type, seed, freq, interp, fractal, octaves, lacunarity, gain, dist, value, dist2ind, jitter, pertube, pertube_amp);
+  NoiseHandle* handle = new NoiseHandle{noise, FastNoiseT<float>(noise), (Generator) type, pertube, threads, single};
+  return cpp11::external_pointer<NoiseHandle>(handle);
+}
+
+[[cpp11::register]]
+cpp11::writable::doubles noise_handle_eval_c(SEXP handle, SEXP x, SEXP y, SEXP z, SEXP t) {
+  cpp11::external_pointer<NoiseHandle> ptr(handle);
+  const NoiseHandle* gen = ptr.get();
+  if (gen == nullptr) {
+    cpp11::stop("The generator is no longer valid. Generators can't be saved and restored across sessions");
+  }
+  if (z == R_NilValue && t != R_NilValue) cpp11::stop("`z` must be given when `t` is");
+  int dims = z == R_NilValue ? 2 : (t == R_NilValue ? 3 : 4);
+  if (dims == 4 && gen->type != SimplexGen && gen->type != WhiteGen) {
+    cpp11::stop("4D noise is only available for simplex and white noise");
+  }
+  if (dims == 4 && gen->noise.GetNoiseType() == FastNoise::SimplexFractal) {
+    cpp11::stop("4D simplex noise does not support fractals");
+  }
+
+  SEXP axes[] = {x, y, z, t};
+  R_xlen_t n = 0;
+  for (int d = 0; d < dims; ++d) {
+    n = std::max(n, Rf_xlength(axes[d]));
+  }
+  // A missing y lies at 0 like in the gen_*() functions
+  std::vector<double> buffers[4];
+  PointAxis coords[4];
+  for (int d = 0; d < dims; ++d) {
+    if (axes[d] == R_NilValue) {
+      buffers[d].assign(n, 0.0);
+      coords[d] = buffer_axis(buffers[d]);
+    } else {
+      coords[d] = handle_coords(axes[d], n, buffers[d]);
+    }
+  }
+
+  cpp11::writable::doubles noise(n);
+  double* out = REAL(noise.data());
+  if (gen->single) {
+    handle_eval(out, (int) n, dims, coords, gen->noise_single, gen->pertube, gen->threads);
+  } else {
+    handle_eval(out, (int) n, dims, coords, gen->noise, gen->pertube, gen->threads);
+  }
+  return noise;
+}
@@ -0,0 +1,354 @@
+#include <cpp11/declarations.hpp>
+#include <cpp11/external_pointer.hpp>
+#include <cpp11/integers.hpp>
+#include <cpp11/list.hpp>
+#include <R_ext/Altrep.h>
+#include <R_ext/Rdynload.h>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "FastNoise.h"
+#include "generator.h"
+#include "lazy_noise.h"
+#include "noise.h"
+
+// Lazy noise_*() results. The noise grid is generated tile by tile as elements
+// are accessed, and the most recently used tiles are kept so that neighbouring
+// accesses are served from memory. data1 holds list(<LazyNoise>, config) where
+// config is the list of settings the result was created from, and data2 the
+// materialised vector once something asks for a pointer to the data
+static R_altrep_class_t lazy_noise_class;
+
+// The settings are passed from R as a list in this order
+enum LazyConfig {
+  LazyType, LazySeed, LazyFreq, LazyInterp, LazyFractal, LazyOctaves,
+  LazyLacunarity, LazyGain, LazyDist, LazyValue, LazyDist2ind, LazyJitter,
+  LazyPertube, LazyPertubeAmp, LazyDim, LazyThreads, LazySingle, LazySeeding,
+  LazyConfigSize
+};
+
+// Tiles are kept up to 64MB per result and computed in batches of at most
+// `lazy_batch_tiles` when a region is read
+static const std::size_t lazy_cache_tiles = (64 << 20) / (sizeof(double) * grid_tile_rows * grid_tile_cols);
+static const int lazy_batch_tiles = 64;
+
+typedef std::shared_ptr< std::vector<double> > LazyTile;
+
+class LazyNoise {
+public:
+  LazyNoise(LazyTiles* tiles, int threads) : tiles_(tiles), threads_(threads) {}
+
+  R_xlen_t size() const {
+    return (R_xlen_t) tiles_->height * tiles_->width * tiles_->slabs;
+  }
+
+  double elt(R_xlen_t k) {
+    int tile, offset, run;
+    locate(k, tile, offset, run);
+    LazyTile data;
+    acquire(&tile, 1, &data);
+    return (*data)[offset];
+  }
+
+  R_xlen_t get_region(R_xlen_t start, R_xlen_t n, double* buf) {
+    n = std::min(n, size() - start);
+    if (n <= 0) return 0;
+    struct Run {
+      R_xlen_t at;
+      int slot;
+      int offset;
+      int length;
+    };
+    std::vector<int> batch;
+    std::vector<Run> runs;
+    std::vector<LazyTile> data;
+    R_xlen_t k = start;
+    while (k < start + n) {
+      // Runs down the columns of a tile until `lazy_batch_tiles` tiles are
+      // involved. Consecutive runs cycle through the tiles of a tile column so
+      // those are looked up among the tiles already in the batch
+      batch.clear();
+      runs.clear();
+      while (k < start + n) {
+        Run run;
+        int tile;
+        locate(k, tile, run.offset, run.length);
+        run.length = (int) std::min<R_xlen_t>(run.length, start + n - k);
+        run.at = k - start;
+        run.slot = (int) (std::find(batch.begin(), batch.end(), tile) - batch.begin());
+        if (run.slot == (int) batch.size()) {
+          if (run.slot == lazy_batch_tiles) break;
+          batch.push_back(tile);
+        }
+        runs.push_back(run);
+        k += run.length;
+      }
+      data.resize(batch.size());
+      acquire(batch.data(), batch.size(), data.data());
+      for (size_t r = 0; r < runs.size(); ++r) {
+        const double* from = data[runs[r].slot]->data() + runs[r].offset;
+        std::copy(from, from + runs[r].length, buf + runs[r].at);
+      }
+    }
+    return n;
+  }
+
+  // Generates the full grid in one go and drops the cached tiles
+  void fill(double* out) {
+    tiles_->fill_slabs(0, tiles_->slabs, out, threads_);
+    lru_.clear();
+    cache_.clear();
+  }
+
+private:
+  // The tile holding element `k`, its offset into the tile, and the number of
+  // elements from `k` down the same tile column
+  void locate(R_xlen_t k, int& tile, int& offset, int& run) const {
+    R_xlen_t slab_size = (R_xlen_t) tiles_->height * tiles_->width;
+    int slab = (int) (k / slab_size);
+    R_xlen_t rest = k % slab_size;
+    int j = (int) (rest / tiles_->height);
+    int i = (int) (rest % tiles_->height);
+    tile = (slab * tiles_->col_tiles + j / grid_tile_cols) * tiles_->row_tiles + i / grid_tile_rows;
+    offset = (j % grid_tile_cols) * grid_tile_rows + i % grid_tile_rows;
+    run = std::min(grid_tile_rows - i % grid_tile_rows, tiles_->height - i);
+  }
+
+  // Looks up `n` distinct tiles, computing the ones not in the cache together
+  void acquire(const int* tiles, int n, LazyTile* out) {
+    std::vector<int> missing;
+    for (int t = 0; t < n; ++t) {
+      auto it = cache_.find(tiles[t]);
+      if (it == cache_.end()) {
+        missing.push_back(t);
+        continue;
+      }
+      lru_.splice(lru_.begin(), lru_, it->second.second);
+      out[t] = it->second.first;
+    }
+    if (missing.empty()) return;
+
+    std::vector<int> tile_ids(missing.size());
+    std::vector<double*> buffers(missing.size());
+    for (size_t m = 0; m < missing.size(); ++m) {
+      out[missing[m]] = std::make_shared< std::vector<double> >(grid_tile_rows * grid_tile_cols);
+      tile_ids[m] = tiles[missing[m]];
+      buffers[m] = out[missing[m]]->data();
+    }
+    tiles_->compute(tile_ids.data(), tile_ids.size(), buffers.data(), threads_);
+    for (size_t m = 0; m < missing.size(); ++m) {
+      lru_.push_front(tile_ids[m]);
+      cache_[tile_ids[m]] = std::make_pair(out[missing[m]], lru_.begin());
+    }
+    while (cache_.size() > lazy_cache_tiles) {
+      cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  std::unique_ptr<LazyTiles> tiles_;
+  int threads_;
+  std::list<int> lru_;
+  std::unordered_map< int, std::pair< LazyTile, std::list<int>::iterator > > cache_;
+};
+
+inline LazyNoise* lazy_state(SEXP x) {
+  cpp11::external_pointer<LazyNoise> ptr(VECTOR_ELT(R_altrep_data1(x), 0));
+  return ptr.get();
+}
+
+NoiseConfig noise_config(SEXP config) {
+  if (TYPEOF(config) != VECSXP || Rf_xlength(config) != LazyConfigSize) {
+    cpp11::stop("Malformed noise settings");
+  }
+  NoiseConfig res;
+  res.type = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyType));
+  if (res.type < PerlinGen || res.type > WhiteGen) cpp11::stop("Unknown generator type");
+  res.seed = cpp11::as_cpp<int>(VECTOR_ELT(config, LazySeed));
+  res.freq = cpp11::as_cpp<double>(VECTOR_ELT(config, LazyFreq));
+  res.interp = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyInterp));
+  res.fractal = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyFractal));
+  res.octaves = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyOctaves));
+  res.lacunarity = cpp11::as_cpp<double>(VECTOR_ELT(config, LazyLacunarity));
+  res.gain = cpp11::as_cpp<double>(VECTOR_ELT(config, LazyGain));
+  res.dist = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyDist));
+  res.value = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyValue));
+  cpp11::integers dist2ind(VECTOR_ELT(config, LazyDist2ind));
+  if (dist2ind.size() != 2) cpp11::stop("`distance_ind` must have two elements");
+  res.dist2ind[0] = dist2ind[0];
+  res.dist2ind[1] = dist2ind[1];
+  res.jitter = cpp11::as_cpp<double>(VECTOR_ELT(config, LazyJitter));
+  res.pertube = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyPertube));
+  res.pertube_amp = cpp11::as_cpp<double>(VECTOR_ELT(config, LazyPertubeAmp));
+  res.threads = cpp11::as_cpp<int>(VECTOR_ELT(config, LazyThreads));
+  res.single = cpp11::as_cpp<bool>(VECTOR_ELT(config, LazySingle));
+  res.seeding = seed_mode(VECTOR_ELT(config, LazySeeding));
+
+  cpp11::integers dim(VECTOR_ELT(config, LazyDim));
+  res.dims = dim.size();
+  if (res.dims < 2 || res.dims > 4) cpp11::stop("Noise grids can only be generated in 2 to 4 dimensions");
+  if (res.dims == 4 && res.type != SimplexGen && res.type != WhiteGen) {
+    cpp11::stop("4D noise is only available for simplex and white noise");
+  }
+  for (int d = 0; d < 4; ++d) {
+    res.dim[d] = d < res.dims ? dim[d] : 1;
+    if (res.dim[d] < 0 || res.dim[d] == NA_INTEGER) cpp11::stop("Dimensions must be positive");
+  }
+
+  res.generator = noise_generator_c(
+    (Generator) res.type, res.seed, res.freq, res.interp, res.fractal,
+    res.octaves, res.lacunarity, res.gain, res.dist, res.value, dist2ind,
+    res.jitter, res.pertube, res.pertube_amp
+  );
+  // The seeding in effect when the noise was first generated, so restored
+  // copies give the same noise
+  res.generator.SetSeed(res.seed, res.seeding);
+  if (res.dims == 4 && res.type == SimplexGen) res.generator.SetNoiseType(FastNoise::Simplex);
+  return res;
+}
+
+// FNV-1a over the bytes of each setting in turn
+template <typename V>
+inline void hash_setting(uint64_t& hash, const V& value) {
+  const unsigned char* bytes = (const unsigned char*) &value;
+  for (size_t b = 0; b < sizeof(V); ++b) {
+    hash = (hash ^ bytes[b]) * 1099511628211ull;
+  }
+}
+
+uint64_t noise_config_hash(const NoiseConfig& config) {
+  uint64_t hash = 14695981039346656037ull;
+  hash_setting(hash, config.type);
+  hash_setting(hash, config.seed);
+  hash_setting(hash, config.freq);
+  hash_setting(hash, config.interp);
+  hash_setting(hash, config.fractal);
+  hash_setting(hash, config.octaves);
+  hash_setting(hash, config.lacunarity);
+  hash_setting(hash, config.gain);
+  hash_setting(hash, config.dist);
+  hash_setting(hash, config.value);
+  hash_setting(hash, config.dist2ind[0]);
+  hash_setting(hash, config.dist2ind[1]);
+  hash_setting(hash, config.jitter);
+  hash_setting(hash, config.pertube);
+  hash_setting(hash, config.pertube_amp);
+  hash_setting(hash, config.dims);
+  for (int d = 0; d < 4; ++d) {
+    hash_setting(hash, config.dim[d]);
+  }
+  hash_setting(hash, (int) config.single);
+  hash_setting(hash, (int) config.seeding);
+  return hash;
+}
+
+LazyTiles* noise_config_tiles(const NoiseConfig& config) {
+  const int* dim = config.dim;
+  if (config.type == WhiteGen) {
+    return white_lazy_tiles(config.generator, dim[0], dim[1], dim[2], dim[3], config.dims, config.pertube, config.single);
+  }
+  if (config.single) {
+    return noise_lazy_tiles<float>(config.generator, dim[0], dim[1], dim[2], dim[3], config.dims, config.pertube);
+  }
+  return noise_lazy_tiles<double>(config.generator, dim[0], dim[1], dim[2], dim[3], config.dims, config.pertube);
+}
+
+// Sets up the generator of a noise_*() call from its settings and wraps it in
+// a lazy vector with the dimensions of the grid
+static SEXP new_lazy_noise(SEXP config) {
+  NoiseConfig settings = noise_config(config);
+  LazyTiles* tiles = noise_config_tiles(settings);
+  cpp11::external_pointer<LazyNoise> state(new LazyNoise(tiles, settings.threads));
+
+  SEXP data1 = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(data1, 0, state);
+  SET_VECTOR_ELT(data1, 1, config);
+  SEXP noise = PROTECT(R_new_altrep(lazy_noise_class, data1, R_NilValue));
+  Rf_setAttrib(noise, R_DimSymbol, VECTOR_ELT(config, LazyDim));
+  UNPROTECT(2);
+  return noise;
+}
+
+static R_xlen_t lazy_length(SEXP x) {
+  return lazy_state(x)->size();
+}
+
+static double lazy_elt(SEXP x, R_xlen_t i) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) return REAL(materialised)[i];
+  return lazy_state(x)->elt(i);
+}
+
+static R_xlen_t lazy_get_region(SEXP x, R_xlen_t i, R_xlen_t n, double* buf) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) {
+    n = std::min(n, Rf_xlength(materialised) - i);
+    std::copy(REAL(materialised) + i, REAL(materialised) + i + n, buf);
+    return n;
+  }
+  return lazy_state(x)->get_region(i, n, buf);
+}
+
+static void* lazy_dataptr(SEXP x, Rboolean) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised == R_NilValue) {
+    LazyNoise* state = lazy_state(x);
+    materialised = PROTECT(Rf_allocVector(REALSXP, state->size()));
+    state->fill(REAL(materialised));
+    R_set_altrep_data2(x, materialised);
+    UNPROTECT(1);
+  }
+  return REAL(materialised);
+}
+
+static const void* lazy_dataptr_or_null(SEXP x) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised == R_NilValue) return nullptr;
+  return REAL(materialised);
+}
+
+// Saved as the settings so the noise is regenerated lazily when read back.
+// Materialised results may have been modified and are saved as ordinary vectors
+static SEXP lazy_serialized_state(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  return VECTOR_ELT(R_altrep_data1(x), 1);
+}
+
+static SEXP lazy_unserialize(SEXP, SEXP state) {
+  BEGIN_CPP11
+  return new_lazy_noise(state);
+  END_CPP11
+}
+
+// Copies share the generator and cached tiles until they are modified
+static SEXP lazy_duplicate(SEXP x, Rboolean) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  return R_new_altrep(lazy_noise_class, R_altrep_data1(x), R_NilValue);
+}
+
+// The key of noise generated from `config` in the on-disk noise cache
+[[cpp11::register]]
+std::string noise_settings_key_c(cpp11::list config) {
+  return hash_key(noise_config_hash(noise_config(config)));
+}
+
+[[cpp11::register]]
+SEXP noise_lazy_c(cpp11::list config) {
+  return new_lazy_noise(config);
+}
+
+[[cpp11::init]]
+void init_lazy_noise(DllInfo* dll) {
+  lazy_noise_class = R_make_altreal_class("lazy_noise", "ambient", dll);
+  R_set_altrep_Length_method(lazy_noise_class, lazy_length);
+  R_set_altrep_Serialized_state_method(lazy_noise_class, lazy_serialized_state);
+  R_set_altrep_Unserialize_method(lazy_noise_class, lazy_unserialize);
+  R_set_altrep_Duplicate_method(lazy_noise_class, lazy_duplicate);
+  R_set_altvec_Dataptr_method(lazy_noise_class, lazy_dataptr);
+  R_set_altvec_Dataptr_or_null_method(lazy_noise_class, lazy_dataptr_or_null);
+  R_set_altreal_Elt_method(lazy_noise_class, lazy_elt);
+  R_set_altreal_Get_region_method(lazy_noise_class, lazy_get_region);
+}
@@ -0,0 +1,117 @@
+#ifndef AMBIENT_LAZY_NOISE_H
+#define AMBIENT_LAZY_NOISE_H
+
+#include <cpp11/R.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "FastNoise.h"
+#include "parallel.h"
+
+// The tiles of a noise grid (see parallel_grid()), evaluated on request for a
+// lazy noise_*() result or slab by slab when streaming the grid to a file.
+// Tiles are written column-major with `grid_tile_rows` between the starts of
+// neighbouring columns
+class LazyTiles {
+public:
+  LazyTiles(int height, int width, int slabs) :
+    height(height), width(width), slabs(slabs),
+    row_tiles((height + grid_tile_rows - 1) / grid_tile_rows),
+    col_tiles((width + grid_tile_cols - 1) / grid_tile_cols) {}
+  virtual ~LazyTiles() {}
+
+  // Evaluates the `n` tiles in `tiles` into `out`
+  virtual void compute(const int* tiles, int n, double* const* out, int threads) const = 0;
+  // Evaluates `n` slabs of the grid, starting at slab `first`, into `out` like
+  // the eager noise_*() functions
+  virtual void fill_slabs(int first, int n, double* out, int threads) const = 0;
+
+  const int height;
+  const int width;
+  const int slabs;
+  const int row_tiles;
+  const int col_tiles;
+};
+
+// Tiles evaluated with the row functor `F` of the eager grid, so the lazy
+// result is identical to the eager one. The generator is owned by the tiles
+// and `F` is constructed from it followed by `args`
+template <typename T, typename F>
+class LazyTilesT : public LazyTiles {
+public:
+  template <typename... Args>
+  LazyTilesT(const FastNoise& noise_gen, int height, int width, int slabs, Args... args) :
+    LazyTiles(height, width, slabs), noise_gen_(noise_gen), rows_(noise_gen_, args...) {}
+
+  void compute(const int* tiles, int n, double* const* out, int threads) const {
+    parallel_for(n, threads, [&](int begin, int end) {
+      F fun(rows_);
+      std::vector<T> buffer;
+      for (int t = begin; t < end; ++t) {
+        grid_tile<T>(fun, buffer, height, width, tiles[t], out[t], grid_tile_rows);
+      }
+    });
+  }
+
+  void fill_slabs(int first, int n, double* out, int threads) const {
+    int slab_tiles = row_tiles * col_tiles;
+    parallel_for(n * slab_tiles, threads, [&](int begin, int end) {
+      F fun(rows_);
+      std::vector<T> buffer;
+      for (int t = begin; t < end; ++t) {
+        int i0 = (t % row_tiles) * grid_tile_rows;
+        int j0 = (t / row_tiles % col_tiles) * grid_tile_cols;
+        int slab = t / slab_tiles;
+        double* tile_out = out + (std::ptrdiff_t) slab * width * height + (std::ptrdiff_t) j0 * height + i0;
+        grid_tile<T>(fun, buffer, height, width, first * slab_tiles + t, tile_out, height);
+      }
+    });
+  }
+
+private:
+  FastNoiseT<T> noise_gen_;
+  F rows_;
+};
+
+// The settings of a noise_*() call, as collected by noise_config() on the R
+// side, along with the generator they describe
+struct NoiseConfig {
+  FastNoise generator;
+  int type;
+  int seed;
+  double freq;
+  int interp;
+  int fractal;
+  int octaves;
+  double lacunarity;
+  double gain;
+  int dist;
+  int value;
+  int dist2ind[2];
+  double jitter;
+  int pertube;
+  double pertube_amp;
+  int dims;
+  int dim[4];
+  int threads;
+  bool single;
+  FastNoise::SeedMode seeding;
+};
+NoiseConfig noise_config(SEXP config);
+LazyTiles* noise_config_tiles(const NoiseConfig& config);
+// A hash of every setting that affects the values of the noise, i.e. all but
+// the number of threads
+uint64_t noise_config_hash(const NoiseConfig& config);
+
+// The hash as used for naming cache files
+inline std::string hash_key(uint64_t hash) {
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", (unsigned long long) hash);
+  return key;
+}
+
+// The tiles of white_grid_2d/3d/4d(), defined alongside them
+LazyTiles* white_lazy_tiles(const FastNoise& noise_gen, int height, int width, int depth, int time, int dims, int pertube, bool single);
+
+#endif
@@ -0,0 +1,156 @@
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <random>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), mapping_(nullptr) {}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+  close();
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    error = "Unable to open file";
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    error = "Unable to determine the file size";
+    return false;
+  }
+  size_ = (std::size_t) size.QuadPart;
+  if (size_ == 0) {
+    CloseHandle(file);
+    return true;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (mapping == NULL) {
+    size_ = 0;
+    error = "Unable to map file";
+    return false;
+  }
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == NULL) {
+    CloseHandle(mapping);
+    size_ = 0;
+    error = "Unable to map file";
+    return false;
+  }
+  mapping_ = mapping;
+  data_ = (const unsigned char*) data;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) UnmapViewOfFile(data_);
+  if (mapping_ != nullptr) CloseHandle((HANDLE) mapping_);
+  data_ = nullptr;
+  mapping_ = nullptr;
+  size_ = 0;
+}
+
+// Moving a file onto an existing one fails, in which case another process has
+// written the same file first
+static bool rename_file(const std::string& from, const std::string& to) {
+  return MoveFileExA(from.c_str(), to.c_str(), 0) != 0;
+}
+
+void touch_file(const std::string& path) {
+  HANDLE file = CreateFileA(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return;
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  SetFileTime(file, NULL, NULL, &now);
+  CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile() : data_(nullptr), size_(0) {}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = std::strerror(errno);
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    error = std::strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  size_ = (std::size_t) info.st_size;
+  if (size_ == 0) {
+    ::close(fd);
+    return true;
+  }
+  // The mapping stays valid after the descriptor is closed
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    error = std::strerror(errno);
+    size_ = 0;
+    return false;
+  }
+  data_ = (const unsigned char*) data;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) munmap((void*) data_, size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+static bool rename_file(const std::string& from, const std::string& to) {
+  return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+void touch_file(const std::string& path) {
+  utimes(path.c_str(), nullptr);
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool write_file_atomic(const std::string& path, const void* data, std::size_t size) {
+  static const char digits[] = "0123456789abcdef";
+  std::random_device rd;
+  std::string tmp = path + ".";
+  for (int i = 0; i < 4; ++i) {
+    unsigned int bits = rd();
+    for (int k = 0; k < 8; ++k, bits >>= 4) {
+      tmp += digits[bits & 15];
+    }
+  }
+  tmp += ".tmp";
+  std::FILE* file = std::fopen(tmp.c_str(), "wb");
+  if (file == nullptr) return false;
+  bool written = std::fwrite(data, 1, size, file) == size;
+  written = std::fclose(file) == 0 && written;
+  if (!written || !rename_file(tmp, path)) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,39 @@
+#ifndef AMBIENT_MAPPED_FILE_H
+#define AMBIENT_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// A file mapped read-only into memory along with other file system utilities.
+// Kept free of R headers as the Windows API clashes with them
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Maps the file at `path`, returning false and setting `error` on failure
+  bool open(const std::string& path, std::string& error);
+  void close();
+
+  const unsigned char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  const unsigned char* data_;
+  std::size_t size_;
+#ifdef _WIN32
+  void* mapping_;
+#endif
+};
+
+// Writes `size` bytes to `path` through a temporary file next to it that is
+// renamed into place, so concurrent readers and writers never see a partially
+// written file. Returns false if the file could not be written
+bool write_file_atomic(const std::string& path, const void* data, std::size_t size);
+
+// Sets the modification time of the file at `path` to now
+void touch_file(const std::string& path);
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef AMBIENT_NOISE_H
+#define AMBIENT_NOISE_H
+
+#include <algorithm>
+#include <vector>
+#include "FastNoise.h"
+#include "FastNoiseGrid.h"
+#include "lazy_noise.h"
+#include "parallel.h"
+
+// Drivers evaluating the noise type set on a generator over a grid or a set of
+// points. They are templated on the precision of the generator, the result
+// always being written as double.
+
+// Evaluates rows of a grid with the batch kernels. Slab `s` of a grid with
+// `depth` slices along z lies at z = s % depth and t = s / depth. The grid can
+// be moved away from the origin with `x0`, `y0`, and `z0`. Perturbation is
+// applied to the whole row of coordinates up front so nothing is decided per
+// pixel
+template <typename T>
+class BatchRows {
+public:
+  BatchRows(const FastNoiseT<T>& noise_gen, int dims, int depth, int pertube, double x0 = 0, double y0 = 0, double z0 = 0) :
+    noise_gen_(noise_gen), dims_(dims), depth_(depth), pertube_(pertube),
+    x0_(x0), y0_(y0), z0_(z0), coords_(dims * grid_tile_cols) {}
+
+  void operator()(int i, int slab, int j, int n, T* res) {
+    T* coords[4];
+    for (int d = 0; d < dims_; ++d) {
+      coords[d] = coords_.data() + d * grid_tile_cols;
+    }
+    for (int c = 0; c < n; ++c) {
+      coords[0][c] = (T) (x0_ + (j + c));
+    }
+    std::fill(coords[1], coords[1] + n, (T) (y0_ + i));
+    if (dims_ > 2) std::fill(coords[2], coords[2] + n, (T) (z0_ + slab % depth_));
+    if (dims_ > 3) std::fill(coords[3], coords[3] + n, (T) (slab / depth_));
+    if (pertube_ != 0) {
+      noise_gen_.GradientPerturbBatch(dims_, coords, n, pertube_ == 2);
+    }
+    noise_gen_.GetNoiseBatch(dims_, coords, res, n);
+  }
+
+private:
+  const FastNoiseT<T>& noise_gen_;
+  int dims_;
+  int depth_;
+  int pertube_;
+  double x0_;
+  double y0_;
+  double z0_;
+  std::vector<T> coords_;
+};
+
+// Unperturbed value, perlin and cubic grids share their lattice along rows and
+// columns and are evaluated through FastNoiseGrid instead, which keeps the
+// lattice corners of the rows it has seen
+template <typename T>
+class LatticeRows {
+public:
+  LatticeRows(const FastNoiseT<T>& noise_gen, int width, int dims) :
+    grid_(noise_gen, width), dims_(dims) {}
+
+  void operator()(int i, int slab, int j, int n, T* res) {
+    if (dims_ == 2) {
+      grid_.Row((T) i, j, n, res);
+    } else {
+      grid_.Row((T) i, (T) slab, j, n, res);
+    }
+  }
+
+private:
+  FastNoiseGrid<T> grid_;
+  int dims_;
+};
+
+// Grids are generated tile by tile in column-major order (see parallel_grid())
+template <typename T>
+void noise_grid_2d(double* out, int height, int width, const FastNoiseT<T>& noise_gen, int pertube, int threads) {
+  if (pertube == 0 && FastNoiseGrid<T>::Supports(noise_gen)) {
+    parallel_grid<T>(out, height, width, 1, threads, LatticeRows<T>(noise_gen, width, 2));
+  } else {
+    parallel_grid<T>(out, height, width, 1, threads, BatchRows<T>(noise_gen, 2, 1, pertube));
+  }
+}
+
+template <typename T>
+void noise_grid_3d(double* out, int height, int width, int depth, const FastNoiseT<T>& noise_gen, int pertube, int threads) {
+  if (pertube == 0 && FastNoiseGrid<T>::Supports(noise_gen)) {
+    parallel_grid<T>(out, height, width, depth, threads, LatticeRows<T>(noise_gen, width, 3));
+  } else {
+    parallel_grid<T>(out, height, width, depth, threads, BatchRows<T>(noise_gen, 3, depth, pertube));
+  }
+}
+
+// There is no 4D perturbation
+template <typename T>
+void noise_grid_4d(double* out, int height, int width, int depth, int time, const FastNoiseT<T>& noise_gen, int threads) {
+  parallel_grid<T>(out, height, width, depth * time, threads, BatchRows<T>(noise_gen, 4, depth, 0));
+}
+
+// The tiles of noise_grid_2d/3d/4d() for a lazy result
+template <typename T>
+LazyTiles* noise_lazy_tiles(const FastNoise& noise_gen, int height, int width, int depth, int time, int dims, int pertube) {
+  if (dims < 4 && pertube == 0 && FastNoiseGrid<T>::Supports(FastNoiseT<T>(noise_gen))) {
+    return new LazyTilesT< T, LatticeRows<T> >(noise_gen, height, width, depth, width, dims);
+  }
+  return new LazyTilesT< T, BatchRows<T> >(noise_gen, height, width, depth * time, dims, depth, dims < 4 ? pertube : 0);
+}
+
+// A `size` x `size` (x `size`) grid whose first element lies at `origin`, for
+// noise_tiles(). Grids are evaluated with the batch kernels wherever they lie,
+// so neighbouring grids agree where they overlap
+template <typename T>
+void noise_grid_at(double* out, int size, int dims, const double* origin, const FastNoiseT<T>& noise_gen, int pertube, int threads) {
+  int depth = dims == 3 ? size : 1;
+  parallel_grid<T>(out, size, size, depth, threads, BatchRows<T>(noise_gen, dims, depth, pertube, origin[0], origin[1], origin[2]));
+}
+void white_grid_at(double* out, int size, int dims, const double* origin, const FastNoise& noise_gen, int pertube, bool single, int threads);
+
+template <int D, typename T>
+void noise_points(double* out, int n, const PointAxis* coords, const FastNoiseT<T>& generator, const std::vector<int>& order, int threads) {
+  parallel_batches<D, T>(n, threads, order, coords, out, [&](const T* const* c, T* res, int m) {
+    generator.GetNoiseBatch(D, c, res, m);
+  });
+}
+
+#endif
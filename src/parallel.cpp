@@ -0,0 +1,185 @@
+#include "parallel.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static long current_pid() {
+#ifdef _WIN32
+  return 0;
+#else
+  return (long) getpid();
+#endif
+}
+
+// Set on the pool's own threads so nested parallel loops run inline
+static thread_local bool is_pool_worker = false;
+
+PoolJob::PoolJob(int n, int threads, int tile, void (*run_fun)(void*, int, int), void* f) :
+  run(run_fun), fun(f), tile_size(tile), n_slots(threads), ranges(new TileRange[threads]),
+  helpers_left(threads - 1) {
+  // Start out with an even split, stealing takes care of the imbalance
+  for (int i = 0; i < threads; ++i) {
+    ranges[i].begin = (int) ((long long) n * i / threads);
+    ranges[i].end = (int) ((long long) n * (i + 1) / threads);
+  }
+}
+
+bool PoolJob::take(int slot, int& begin, int& end) {
+  TileRange& range = ranges[slot];
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if (range.begin >= range.end) return false;
+  begin = range.begin;
+  end = std::min(range.begin + tile_size, range.end);
+  range.begin = end;
+  return true;
+}
+
+bool PoolJob::steal(int slot) {
+  for (int i = 1; i < n_slots; ++i) {
+    TileRange& victim = ranges[(slot + i) % n_slots];
+    int begin, end;
+    {
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      int left = victim.end - victim.begin;
+      if (left <= 0) continue;
+      begin = left <= tile_size ? victim.begin : victim.begin + left / 2;
+      end = victim.end;
+      victim.end = begin;
+    }
+    TileRange& own = ranges[slot];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.begin = begin;
+    own.end = end;
+    return true;
+  }
+  return false;
+}
+
+void PoolJob::work(int slot) {
+  int begin, end;
+  do {
+    while (take(slot, begin, end)) {
+      run(fun, begin, end);
+    }
+  } while (steal(slot));
+}
+
+ThreadPool::~ThreadPool() {
+  shutdown();
+}
+
+void ThreadPool::start(int n) {
+  shutdown();
+  stop_ = false;
+  owner_pid_ = current_pid();
+  for (int i = 0; i < n; ++i) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  for (int i = 0; i < n; ++i) {
+    workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+  }
+}
+
+void ThreadPool::shutdown() {
+  if (workers_.empty()) return;
+  if (owner_pid_ != current_pid()) {
+    // Inherited through a fork; the threads only exist in the parent
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      workers_[i].detach();
+    }
+    workers_.clear();
+    queues_.clear();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].join();
+  }
+  workers_.clear();
+  queues_.clear();
+  queued_ = 0;
+}
+
+int ThreadPool::size() const {
+  return (int) workers_.size();
+}
+
+bool ThreadPool::available() const {
+  // Worker threads do not survive a fork (e.g. parallel::mclapply()) so the
+  // child must not wait on them
+  return !is_pool_worker && (workers_.empty() || owner_pid_ == current_pid());
+}
+
+void ThreadPool::run(PoolJob& job, int threads) {
+  if (size() < threads - 1) {
+    start(threads - 1);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int slot = 1; slot < threads; ++slot) {
+      TaskQueue& queue = *queues_[(slot - 1) % queues_.size()];
+      std::lock_guard<std::mutex> queue_lock(queue.mutex);
+      queue.tasks.push_back({&job, slot});
+      ++queued_;
+    }
+  }
+  wake_.notify_all();
+
+  job.work(0);
+
+  // Helpers may still be finishing their last tile, and the job lives on our
+  // stack so we cannot leave before they are done with it
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.done.wait(lock, [&job]() { return job.helpers_left == 0; });
+}
+
+bool ThreadPool::next_task(int id, PoolTask& task) {
+  int n = (int) queues_.size();
+  for (int i = 0; i < n; ++i) {
+    TaskQueue& queue = *queues_[(id + i) % n];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    // Own tasks are taken from the front, stolen ones from the back
+    if (i == 0) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+    } else {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+    }
+    --queued_;
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::worker_loop(int id) {
+  is_pool_worker = true;
+  while (true) {
+    PoolTask task;
+    if (next_task(id, task)) {
+      task.job->work(task.slot);
+      std::lock_guard<std::mutex> lock(task.job->mutex);
+      if (--task.job->helpers_left == 0) task.job->done.notify_one();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+    if (stop_) return;
+  }
+}
+
+ThreadPool& thread_pool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+[[cpp11::register]]
+void pool_shutdown_c() {
+  thread_pool().shutdown();
+}
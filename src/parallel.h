@@ -0,0 +1,247 @@
+#ifndef AMBIENT_PARALLEL_H
+#define AMBIENT_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "point_axis.h"
+
+// The part of a parallel loop owned by one participant. The owner takes tiles
+// from the front while participants that have run dry steal half of what is
+// left from the back.
+struct TileRange {
+  std::mutex mutex;
+  int begin = 0;
+  int end = 0;
+};
+
+// A single parallel loop. `run(fun, begin, end)` evaluates one tile.
+struct PoolJob {
+  void (*run)(void*, int, int);
+  void* fun;
+  int tile_size;
+  int n_slots;
+  std::unique_ptr<TileRange[]> ranges;
+  int helpers_left;
+  std::mutex mutex;
+  std::condition_variable done;
+
+  PoolJob(int n, int threads, int tile, void (*run_fun)(void*, int, int), void* f);
+  void work(int slot);
+
+private:
+  bool take(int slot, int& begin, int& end);
+  bool steal(int slot);
+};
+
+struct PoolTask {
+  PoolJob* job;
+  int slot;
+};
+
+struct TaskQueue {
+  std::mutex mutex;
+  std::deque<PoolTask> tasks;
+};
+
+// Package level pool of persistent workers. Each worker has its own queue of
+// tasks and steals from the others when it runs out. The pool grows on demand
+// to the largest number of threads requested and lives until the package is
+// unloaded.
+class ThreadPool {
+public:
+  ~ThreadPool();
+  // Run `job` with `threads` participants, one being the calling thread.
+  // Returns once every tile has been evaluated.
+  void run(PoolJob& job, int threads);
+  void shutdown();
+  int size() const;
+  // Whether the calling thread can hand work to the pool. This is not the case
+  // on the pool's own workers or in a forked child process.
+  bool available() const;
+
+private:
+  void start(int n);
+  void worker_loop(int id);
+  bool next_task(int id, PoolTask& task);
+
+  std::vector< std::unique_ptr<TaskQueue> > queues_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::atomic<int> queued_{0};
+  bool stop_ = false;
+  long owner_pid_ = 0;
+};
+
+ThreadPool& thread_pool();
+
+template <typename F>
+inline void call_tile(void* fun, int begin, int end) {
+  (*static_cast<F*>(fun))(begin, end);
+}
+
+// Splits the range [0, n) into tiles and evaluates them with up to `threads`
+// participants (the calling thread being one of them). `fun(begin, end)` is
+// called once per tile and must not touch the R API as it may run on a worker
+// thread. Each output element must only depend on its own position for the
+// result to be independent of the number of threads.
+template <typename F>
+inline void parallel_for(int n, int threads, F fun) {
+  if (n <= 0) return;
+  threads = std::min(threads, n);
+  if (threads <= 1 || !thread_pool().available()) {
+    fun(0, n);
+    return;
+  }
+
+  // Many small tiles let expensive regions (e.g. fractal worley) be shared out
+  int tile_size = std::max(1, n / (threads * 16));
+  PoolJob job(n, threads, tile_size, &call_tile<F>, &fun);
+  thread_pool().run(job, threads);
+}
+
+// Fills `slabs` column-major `height` x `width` matrices stored back to back in
+// `out` (the slices of a 3D or 4D volume). The matrices are cut into tiles of
+// `grid_tile_rows` x `grid_tile_cols` that are first evaluated row by row into
+// a local buffer and then written out column by column, so the output is
+// written in its native order as contiguous runs rather than with a stride of
+// `height`. Tiles are visited down the columns of a slab and slab by slab.
+// Each participant works on its own copy of `rows` which is called as
+// `rows(i, slab, j, n, res)` to evaluate the `n` columns of row `i` starting at
+// column `j`. The copy may cache anything shared between neighbouring rows.
+const int grid_tile_rows = 64;
+const int grid_tile_cols = 256;
+
+// Evaluates tile `tile` of a `height` x `width` grid with `rows` into `buffer`
+// and writes it column by column to `out`, with `stride` between the starts of
+// neighbouring columns. Tiles are numbered as in parallel_grid()
+template <typename T, typename F>
+inline void grid_tile(F& rows, std::vector<T>& buffer, int height, int width, int tile, double* out, std::ptrdiff_t stride) {
+  int row_tiles = (height + grid_tile_rows - 1) / grid_tile_rows;
+  int col_tiles = (width + grid_tile_cols - 1) / grid_tile_cols;
+  int i0 = (tile % row_tiles) * grid_tile_rows;
+  int j0 = (tile / row_tiles % col_tiles) * grid_tile_cols;
+  int slab = tile / (row_tiles * col_tiles);
+  int n_rows = std::min(grid_tile_rows, height - i0);
+  int n_cols = std::min(grid_tile_cols, width - j0);
+  buffer.resize(grid_tile_rows * grid_tile_cols);
+  for (int r = 0; r < n_rows; ++r) {
+    rows(i0 + r, slab, j0, n_cols, buffer.data() + r * grid_tile_cols);
+  }
+  for (int c = 0; c < n_cols; ++c) {
+    double* column = out + c * stride;
+    const T* values = buffer.data() + c;
+    for (int r = 0; r < n_rows; ++r) {
+      column[r] = values[r * grid_tile_cols];
+    }
+  }
+}
+
+template <typename T, typename F>
+inline void parallel_grid(double* out, int height, int width, int slabs, int threads, const F& rows) {
+  if (height <= 0 || width <= 0) return;
+  int row_tiles = (height + grid_tile_rows - 1) / grid_tile_rows;
+  int col_tiles = (width + grid_tile_cols - 1) / grid_tile_cols;
+  parallel_for(slabs * row_tiles * col_tiles, threads, [&](int begin, int end) {
+    F fun(rows);
+    std::vector<T> buffer;
+    for (int tile = begin; tile < end; ++tile) {
+      int i0 = (tile % row_tiles) * grid_tile_rows;
+      int j0 = (tile / row_tiles % col_tiles) * grid_tile_cols;
+      int slab = tile / (row_tiles * col_tiles);
+      double* tile_out = out + (std::ptrdiff_t) slab * width * height + (std::ptrdiff_t) j0 * height + i0;
+      grid_tile<T>(fun, buffer, height, width, tile, tile_out, height);
+    }
+  });
+}
+
+// Calls `fun(i)` for each of the `n` points in chunks spread over `threads`
+// workers. If `order` is given the points are visited in that order instead of
+// input order. `fun` is responsible for writing its result to position `i`.
+template <typename F>
+inline void parallel_points(int n, int threads, const std::vector<int>& order, F fun) {
+  if (order.empty()) {
+    parallel_for(n, threads, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        fun(i);
+      }
+    });
+  } else {
+    const int* ord = order.data();
+    parallel_for(n, threads, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        fun(ord[i]);
+      }
+    });
+  }
+}
+
+// Hands the input arrays of a batch loop over directly. Only possible when the
+// points are visited in input order by a double precision batch function and
+// all coordinates are plain vectors.
+template <int D, typename F>
+inline bool parallel_batches_direct(int n, int threads, const std::vector<int>& order, const PointAxis* coords, double* out, F& fun, double*) {
+  if (!order.empty()) return false;
+  for (int d = 0; d < D; ++d) {
+    if (coords[d].data == nullptr) return false;
+  }
+  parallel_for(n, threads, [&](int begin, int end) {
+    const double* chunk[D];
+    for (int d = 0; d < D; ++d) {
+      chunk[d] = coords[d].data + begin;
+    }
+    fun(chunk, out + begin, end - begin);
+  });
+  return true;
+}
+template <int D, typename T, typename F>
+inline bool parallel_batches_direct(int, int, const std::vector<int>&, const PointAxis*, double*, F&, T*) {
+  return false;
+}
+
+// Batch counterpart of parallel_points(). `fun(coords, out, n)` evaluates `n`
+// points of type `T` whose coordinates are given as one array per dimension.
+// The input arrays are handed over directly if possible, otherwise the points
+// are gathered into local buffers (converting them to `T`) and the results
+// scattered back.
+template <int D, typename T = double, typename F>
+inline void parallel_batches(int n, int threads, const std::vector<int>& order, const PointAxis* coords, double* out, F fun) {
+  if (parallel_batches_direct<D>(n, threads, order, coords, out, fun, (T*) nullptr)) {
+    return;
+  }
+  const int* ord = order.empty() ? nullptr : order.data();
+  parallel_for(n, threads, [&](int begin, int end) {
+    const int batch_size = 256;
+    T buffer[D][batch_size];
+    T res[batch_size];
+    const T* chunk[D];
+    for (int d = 0; d < D; ++d) {
+      chunk[d] = buffer[d];
+    }
+    for (int b = begin; b < end; b += batch_size) {
+      int m = std::min(batch_size, end - b);
+      for (int d = 0; d < D; ++d) {
+        if (ord == nullptr) {
+          coords[d].fill(b, m, buffer[d]);
+        } else {
+          for (int i = 0; i < m; ++i) {
+            buffer[d][i] = (T) coords[d][ord[b + i]];
+          }
+        }
+      }
+      fun(chunk, res, m);
+      for (int i = 0; i < m; ++i) {
+        out[ord == nullptr ? b + i : ord[b + i]] = res[i];
+      }
+    }
+  });
+}
+
+#endif
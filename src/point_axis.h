@@ -0,0 +1,41 @@
+#ifndef AMBIENT_POINT_AXIS_H
+#define AMBIENT_POINT_AXIS_H
+
+#include <algorithm>
+#include <cstddef>
+
+// One coordinate of the points evaluated by the gen_*() functions. It is
+// either a plain double vector, or a lazy long_grid() axis where point `i`
+// lies at `values[(i / each) % n_values]` and the coordinates of the whole
+// grid never exist in memory
+struct PointAxis {
+  const double* data;
+  const double* values;
+  std::ptrdiff_t n_values;
+  std::ptrdiff_t each;
+
+  double operator[](std::ptrdiff_t i) const {
+    return data != nullptr ? data[i] : values[(i / each) % n_values];
+  }
+
+  // Copies the coordinates of points `begin` to `begin + n` to `out`. Lazy
+  // axes are written in runs of equal values
+  template <typename T>
+  void fill(std::ptrdiff_t begin, int n, T* out) const {
+    if (data != nullptr) {
+      for (int i = 0; i < n; ++i) {
+        out[i] = (T) data[begin + i];
+      }
+      return;
+    }
+    std::ptrdiff_t block = begin / each;
+    std::ptrdiff_t left = each - begin % each;
+    for (int i = 0; i < n; ++block, left = each) {
+      int m = (int) std::min<std::ptrdiff_t>(left, n - i);
+      std::fill(out + i, out + i + m, (T) values[block % n_values]);
+      i += m;
+    }
+  }
+};
+
+#endif
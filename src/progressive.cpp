@@ -0,0 +1,190 @@
+#include <cpp11/declarations.hpp>
+#include <cpp11/external_pointer.hpp>
+#include <cpp11/list.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "FastNoise.h"
+#include "FastNoiseGrid.h"
+#include "generator.h"
+#include "lazy_noise.h"
+#include "parallel.h"
+
+// Progressive noise for noise_progressive(). The running sums (and RigidMulti
+// weights) of GetFractalOctavesBatch() are kept for every pixel between calls,
+// so asking for more octaves only evaluates the ones not added yet. The noise
+// after k octaves is finished as the same noise with k octaves would be, and
+// is thus identical to the noise_*() functions with `octaves = k`
+template <typename T>
+struct ProgressiveSums {
+  std::vector<T> sum;
+  std::vector<T> weight;
+};
+
+struct ProgressiveNoise {
+  NoiseConfig config;
+  FastNoiseT<float> noise_single;
+  ProgressiveSums<float> sums_single;
+  ProgressiveSums<double> sums_double;
+  int octaves;
+  int added;
+};
+
+// Adds octaves [first, last) to all pixels. Pixel (i, j) of slice s lies at
+// (j, i, s) and its sums at ((s * height) + i) * width + j. Noise without a
+// fractal is written as octave 0. Fractal perturbation is applied with all
+// octaves of the generator, so the coordinates don't change between calls
+template <typename T>
+static void progressive_add(const NoiseConfig& config, const FastNoiseT<T>& noise_gen, ProgressiveSums<T>& sums, int first, int last) {
+  if (first >= last) return;
+  int height = config.dim[0];
+  int width = config.dim[1];
+  int dims = config.dims;
+  bool fractal = config.fractal != 0;
+  bool lattice = dims == 2 && config.pertube == 0 && FastNoiseGrid<T>::Supports(noise_gen);
+  int rows = height * (dims == 3 ? config.dim[2] : 1);
+  parallel_for(rows, config.threads, [&](int begin, int end) {
+    std::unique_ptr< FastNoiseGrid<T> > grid;
+    std::vector<T> coords;
+    T* xyz[3];
+    if (lattice) {
+      grid.reset(new FastNoiseGrid<T>(noise_gen, width));
+    } else {
+      coords.resize(dims * width);
+      for (int d = 0; d < dims; ++d) {
+        xyz[d] = coords.data() + d * width;
+      }
+    }
+    for (int r = begin; r < end; ++r) {
+      T* sum = sums.sum.data() + (std::ptrdiff_t) r * width;
+      T* weight = sums.weight.empty() ? nullptr : sums.weight.data() + (std::ptrdiff_t) r * width;
+      if (lattice) {
+        if (fractal) {
+          grid->RowOctaves((T) r, 0, width, sum, weight, first, last);
+        } else {
+          grid->Row((T) r, 0, width, sum);
+        }
+        continue;
+      }
+      for (int c = 0; c < width; ++c) {
+        xyz[0][c] = (T) c;
+      }
+      std::fill(xyz[1], xyz[1] + width, (T) (r % height));
+      if (dims == 3) std::fill(xyz[2], xyz[2] + width, (T) (r / height));
+      if (config.pertube != 0) {
+        noise_gen.GradientPerturbBatch(dims, xyz, width, config.pertube == 2);
+      }
+      if (fractal) {
+        noise_gen.GetFractalOctavesBatch(dims, xyz, sum, weight, width, first, last);
+      } else {
+        noise_gen.GetNoiseBatch(dims, xyz, sum, width);
+      }
+    }
+  });
+}
+
+// Finishes the sums with `octaves` octaves and writes them to the column-major
+// `out`. The sums are kept for later calls, so rows are finished into a band
+// that is transposed into the output
+template <typename T>
+static void progressive_output(const NoiseConfig& config, const FastNoiseT<T>& noise_gen, const ProgressiveSums<T>& sums, int octaves, double* out) {
+  const int band = 64;
+  int height = config.dim[0];
+  int width = config.dim[1];
+  int slices = config.dims == 3 ? config.dim[2] : 1;
+  bool fractal = config.fractal != 0;
+  FastNoiseT<T> finish(noise_gen);
+  if (fractal) finish.SetFractalOctaves(octaves);
+  int bands = (height + band - 1) / band;
+  parallel_for(bands * slices, config.threads, [&](int begin, int end) {
+    std::vector<T> finished((std::size_t) band * width);
+    for (int b = begin; b < end; ++b) {
+      int s = b / bands;
+      int r0 = (b % bands) * band;
+      int r1 = std::min(r0 + band, height);
+      const T* sum = sums.sum.data() + ((std::ptrdiff_t) s * height + r0) * width;
+      std::ptrdiff_t n = (std::ptrdiff_t) (r1 - r0) * width;
+      if (fractal) {
+        finish.FinishFractalBatch(sum, finished.data(), n);
+      } else {
+        std::copy(sum, sum + n, finished.begin());
+      }
+      double* slice = out + (std::ptrdiff_t) s * height * width;
+      for (int c = 0; c < width; ++c) {
+        double* column = slice + (std::ptrdiff_t) c * height;
+        for (int r = r0; r < r1; ++r) {
+          column[r] = finished[(std::ptrdiff_t) (r - r0) * width + c];
+        }
+      }
+    }
+  });
+}
+
+// Brings the sums to `octaves` octaves and returns the finished noise. Asking
+// for fewer octaves than have been added starts over, as octaves can't be
+// taken out of the sums again
+template <typename T>
+static SEXP progressive_noise(ProgressiveNoise& noise, const FastNoiseT<T>& noise_gen, ProgressiveSums<T>& sums, int octaves) {
+  const NoiseConfig& config = noise.config;
+  std::size_t n = (std::size_t) config.dim[0] * config.dim[1] * (config.dims == 3 ? config.dim[2] : 1);
+  if (octaves < noise.added || sums.sum.size() != n) {
+    bool rigid = config.fractal != 0 && noise_gen.GetFractalType() == FastNoise::RigidMulti;
+    sums.sum.assign(n, T(0));
+    sums.weight.assign(rigid ? n : 0, T(1));
+    noise.added = 0;
+  }
+  progressive_add(config, noise_gen, sums, noise.added, octaves);
+  noise.added = octaves;
+
+  SEXP result = PROTECT(Rf_allocVector(REALSXP, n));
+  progressive_output(config, noise_gen, sums, octaves, REAL(result));
+  SEXP dim = PROTECT(Rf_allocVector(INTSXP, config.dims));
+  std::copy(config.dim, config.dim + config.dims, INTEGER(dim));
+  Rf_setAttrib(result, R_DimSymbol, dim);
+  UNPROTECT(2);
+  return result;
+}
+
+static ProgressiveNoise* progressive_get(SEXP progressive) {
+  cpp11::external_pointer<ProgressiveNoise> ptr(progressive);
+  ProgressiveNoise* noise = ptr.get();
+  if (noise == nullptr) {
+    cpp11::stop("The progressive noise is no longer valid. Progressive noise can't be saved and restored across sessions");
+  }
+  return noise;
+}
+
+[[cpp11::register]]
+SEXP noise_progressive_c(cpp11::list config) {
+  NoiseConfig settings = noise_config(config);
+  if (settings.dims > 3) cpp11::stop("Progressive noise can only be generated in 2 or 3 dimensions");
+  if (settings.type == WhiteGen) cpp11::stop("Progressive noise is not available for white noise");
+  int octaves = settings.fractal != 0 ? settings.octaves : 1;
+  cpp11::external_pointer<ProgressiveNoise> ptr(new ProgressiveNoise{
+    settings, FastNoiseT<float>(settings.generator), ProgressiveSums<float>(),
+    ProgressiveSums<double>(), octaves, 0
+  });
+  return ptr;
+}
+
+// The number of octaves added so far and the number available
+[[cpp11::register]]
+cpp11::integers noise_progressive_octaves_c(SEXP progressive) {
+  const ProgressiveNoise* noise = progressive_get(progressive);
+  cpp11::writable::integers octaves(2);
+  octaves[0] = noise->added;
+  octaves[1] = noise->octaves;
+  return octaves;
+}
+
+[[cpp11::register]]
+SEXP noise_progressive_refine_c(SEXP progressive, int octaves) {
+  ProgressiveNoise* noise = progressive_get(progressive);
+  if (octaves == NA_INTEGER || octaves < 1 || octaves > noise->octaves) {
+    cpp11::stop("`octaves` must be between 1 and %i", noise->octaves);
+  }
+  if (noise->config.single) {
+    return progressive_noise(*noise, noise->noise_single, noise->sums_single, octaves);
+  }
+  return progressive_noise(*noise, noise->config.generator, noise->sums_double, octaves);
+}
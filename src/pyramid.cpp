@@ -0,0 +1,282 @@
+#include <cpp11/declarations.hpp>
+#include <cpp11/list.hpp>
+#include <cpp11/matrix.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "FastNoise.h"
+#include "FastNoiseGrid.h"
+#include "generator.h"
+#include "lazy_noise.h"
+#include "parallel.h"
+
+// Pyramids of fractal noise for noise_pyramid(). Level l samples the noise at
+// every 2^l-th pixel of the first level, so its pixel (i, j) lies at
+// (j * 2^l, i * 2^l), and keeps the octaves with a wavelength of at least two
+// of its pixels. Octaves spanning pyramid_share() or more pixels of a level are
+// evaluated at the coarsest such level only, and carried to the finer levels
+// by upsampling the running sums of GetFractalOctavesBatch(). Each level thus
+// only evaluates the octaves that are too fine to be shared from the level
+// above it.
+
+// The number of pixels an octave must span before it is shared from a coarser
+// level. Upsampling a wavelength of 8 pixels keeps the error within a few
+// percent of the octave amplitude. Billow and RigidMulti fold the noise into
+// creases that interpolate less well and are only shared from 32 pixels
+inline double pyramid_share(FastNoise::FractalType fractal) {
+  return fractal == FastNoise::FBM ? 8 : 32;
+}
+
+// floor(f / 2) for negative pixel indices as well
+inline int floor_half(int f) {
+  return f >= 0 ? f / 2 : -((1 - f) / 2);
+}
+
+// The value at pixel `f` of the finer level from the pixels `v` of the coarser
+// one, where v[k * stride] is coarse pixel k0 + k. Even pixels coincide with a
+// coarse pixel and odd ones are interpolated halfway between their neighbours
+// with a Catmull-Rom spline
+template <typename T>
+inline T upsample_at(const T* v, std::ptrdiff_t stride, int k0, int f) {
+  const T* at = v + (floor_half(f) - k0) * stride;
+  if ((f & 1) == 0) return at[0];
+  return (T(9) * (at[0] + at[stride]) - (at[-stride] + at[2 * stride])) / T(16);
+}
+
+// The running sums (and RigidMulti weights) of the pixels [row0, row1) x
+// [col0, col1) of a level in row-major order. Regions may extend past the
+// level so they can be upsampled into the whole of the level below
+template <typename T>
+struct PyramidRegion {
+  int row0;
+  int row1;
+  int col0;
+  int col1;
+  std::vector<T> sum;
+  std::vector<T> weight;
+
+  int rows() const { return row1 - row0; }
+  int cols() const { return col1 - col0; }
+
+  void reset(bool rigid) {
+    sum.assign((std::size_t) rows() * cols(), T(0));
+    weight.assign(rigid ? sum.size() : 0, T(1));
+  }
+};
+
+// Adds octaves [first, last) to all pixels of `region` on level `level`. Noise
+// without a fractal is written as octave 0. Scaling the frequency by a power of
+// 2 is exact, so the level is evaluated on the unit grid of a generator with
+// the frequency scaled to the level, on a lattice coherent grid if possible
+template <typename T>
+static void pyramid_octaves(const FastNoiseT<T>& noise_gen, bool fractal, PyramidRegion<T>& region, int level, int first, int last, int threads) {
+  if (first >= last) return;
+  FastNoiseT<T> level_gen(noise_gen);
+  level_gen.SetFrequency(std::ldexp(noise_gen.GetFrequency(), level));
+  bool lattice = FastNoiseGrid<T>::Supports(level_gen);
+  int cols = region.cols();
+  parallel_for(region.rows(), threads, [&](int begin, int end) {
+    std::unique_ptr< FastNoiseGrid<T> > grid;
+    std::vector<T> coords;
+    T* xy[2];
+    if (lattice) {
+      grid.reset(new FastNoiseGrid<T>(level_gen, cols, region.col0));
+    } else {
+      coords.resize(2 * cols);
+      xy[0] = coords.data();
+      xy[1] = coords.data() + cols;
+      for (int c = 0; c < cols; ++c) {
+        xy[0][c] = (T) (region.col0 + c);
+      }
+    }
+    for (int r = begin; r < end; ++r) {
+      T y = (T) (region.row0 + r);
+      T* sum = region.sum.data() + (std::ptrdiff_t) r * cols;
+      T* weight = region.weight.empty() ? nullptr : region.weight.data() + (std::ptrdiff_t) r * cols;
+      if (lattice) {
+        if (fractal) {
+          grid->RowOctaves(y, 0, cols, sum, weight, first, last);
+        } else {
+          grid->Row(y, 0, cols, sum);
+        }
+        continue;
+      }
+      std::fill(xy[1], xy[1] + cols, y);
+      if (fractal) {
+        level_gen.GetFractalOctavesBatch(2, xy, sum, weight, cols, first, last);
+      } else {
+        level_gen.GetNoiseBatch(2, xy, sum, cols);
+      }
+    }
+  });
+}
+
+// Upsamples `coarse` into the pixels of `fine` on the level below, first along
+// the rows and then along the columns
+template <typename T>
+static void pyramid_upsample(const PyramidRegion<T>& coarse, const std::vector<T>& from, PyramidRegion<T>& fine, std::vector<T>& to, int threads) {
+  int coarse_cols = coarse.cols();
+  int fine_cols = fine.cols();
+  std::vector<T> rows((std::size_t) coarse.rows() * fine_cols);
+  parallel_for(coarse.rows(), threads, [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      const T* in = from.data() + (std::ptrdiff_t) r * coarse_cols;
+      T* out = rows.data() + (std::ptrdiff_t) r * fine_cols;
+      for (int c = 0; c < fine_cols; ++c) {
+        out[c] = upsample_at(in, 1, coarse.col0, fine.col0 + c);
+      }
+    }
+  });
+  parallel_for(fine.rows(), threads, [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      T* out = to.data() + (std::ptrdiff_t) r * fine_cols;
+      for (int c = 0; c < fine_cols; ++c) {
+        out[c] = upsample_at(rows.data() + c, fine_cols, coarse.row0, fine.row0 + r);
+      }
+    }
+  });
+}
+
+template <typename T>
+static void pyramid_upsample(const PyramidRegion<T>& coarse, PyramidRegion<T>& fine, int threads) {
+  pyramid_upsample(coarse, coarse.sum, fine, fine.sum, threads);
+  if (!fine.weight.empty()) {
+    pyramid_upsample(coarse, coarse.weight, fine, fine.weight, threads);
+    // The spline overshoots between steep neighbours
+    for (T& w : fine.weight) w = std::min(std::max(w, T(0)), T(1));
+  }
+}
+
+// Finishes the sums of `level` and writes them to the column-major `out`. Rows
+// are transposed in bands so both sides are accessed in runs
+template <typename T>
+static void pyramid_output(const FastNoiseT<T>& noise_gen, bool fractal, PyramidRegion<T>& level, double* out, int threads) {
+  const int band = 64;
+  int rows = level.rows();
+  int cols = level.cols();
+  parallel_for((rows + band - 1) / band, threads, [&](int begin, int end) {
+    for (int b = begin; b < end; ++b) {
+      int r0 = b * band;
+      int r1 = std::min(r0 + band, rows);
+      T* sum = level.sum.data() + (std::ptrdiff_t) r0 * cols;
+      if (fractal) {
+        for (int r = r0; r < r1; ++r) {
+          noise_gen.FinishFractalBatch(sum + (std::ptrdiff_t) (r - r0) * cols, sum + (std::ptrdiff_t) (r - r0) * cols, cols);
+        }
+      }
+      for (int c = 0; c < cols; ++c) {
+        double* column = out + (std::ptrdiff_t) c * rows;
+        for (int r = r0; r < r1; ++r) {
+          column[r] = sum[(std::ptrdiff_t) (r - r0) * cols + c];
+        }
+      }
+    }
+  });
+}
+
+// The levels of a `height` x `width` pyramid as a list of matrices. `shared[l]`
+// is the number of octaves carried from level l to the level below and
+// `kept[l]` the number of octaves making up level l
+template <typename T>
+static SEXP noise_pyramid(const FastNoiseT<T>& noise_gen, bool fractal, bool rigid, int height, int width, const std::vector<int>& shared, const std::vector<int>& kept, int threads) {
+  int levels = kept.size();
+  // The regions each level needs to upsample into the whole of the one below
+  std::vector<PyramidRegion<T>> regions(levels);
+  regions[0].row0 = 0;
+  regions[0].row1 = height;
+  regions[0].col0 = 0;
+  regions[0].col1 = width;
+  for (int l = 1; l < levels; ++l) {
+    const PyramidRegion<T>& below = regions[l - 1];
+    regions[l].row0 = floor_half(below.row0) - 1;
+    regions[l].row1 = floor_half(below.row1 - 1) + 3;
+    regions[l].col0 = floor_half(below.col0) - 1;
+    regions[l].col1 = floor_half(below.col1 - 1) + 3;
+  }
+
+  cpp11::writable::list result(levels);
+  for (int l = levels - 1; l >= 0; --l) {
+    double spacing = std::ldexp(1.0, l);
+    PyramidRegion<T>& region = regions[l];
+    if (shared[l] > 0) {
+      region.reset(rigid);
+      int first = 0;
+      if (l + 1 < levels && shared[l + 1] > 0) {
+        pyramid_upsample(regions[l + 1], region, threads);
+        first = shared[l + 1];
+      }
+      pyramid_octaves(noise_gen, fractal, region, l, first, shared[l], threads);
+    }
+    if (l + 1 < levels) {
+      regions[l + 1].sum = std::vector<T>();
+      regions[l + 1].weight = std::vector<T>();
+    }
+
+    // The first level is its own region, the others are cropped from theirs
+    int level_height = (int) std::ceil(height / spacing);
+    int level_width = (int) std::ceil(width / spacing);
+    PyramidRegion<T> cropped = {0, level_height, 0, level_width, std::vector<T>(), std::vector<T>()};
+    PyramidRegion<T>& level = l == 0 ? region : cropped;
+    if (l > 0 || shared[l] == 0) level.reset(rigid);
+    if (l > 0 && shared[l] > 0) {
+      for (int r = 0; r < level_height; ++r) {
+        std::ptrdiff_t from = (std::ptrdiff_t) (r - region.row0) * region.cols() - region.col0;
+        std::copy(region.sum.begin() + from, region.sum.begin() + from + level_width, level.sum.begin() + (std::ptrdiff_t) r * level_width);
+        if (rigid) {
+          std::copy(region.weight.begin() + from, region.weight.begin() + from + level_width, level.weight.begin() + (std::ptrdiff_t) r * level_width);
+        }
+      }
+    }
+    pyramid_octaves(noise_gen, fractal, level, l, shared[l], kept[l], threads);
+
+    cpp11::writable::doubles_matrix<> noise(level_height, level_width);
+    pyramid_output(noise_gen, fractal, level, REAL(noise.data()), threads);
+    SET_VECTOR_ELT(result, l, noise);
+    cpp11::check_user_interrupt();
+  }
+  return result;
+}
+
+[[cpp11::register]]
+SEXP noise_pyramid_c(cpp11::list config, int levels) {
+  NoiseConfig settings = noise_config(config);
+  if (settings.dims != 2) cpp11::stop("Noise pyramids can only be generated in 2 dimensions");
+  if (settings.type == WorleyGen || settings.type == WhiteGen) {
+    cpp11::stop("Noise pyramids are only available for perlin, simplex, value, and cubic noise");
+  }
+  if (settings.pertube != 0) cpp11::stop("Noise pyramids can't be perturbed");
+  if (levels < 1 || levels == NA_INTEGER) cpp11::stop("`levels` must be positive");
+  bool fractal = settings.fractal != 0;
+  if (fractal && !(settings.lacunarity > 1)) {
+    cpp11::stop("`lacunarity` must be larger than 1 for noise pyramids");
+  }
+
+  // Level l keeps the octaves with a wavelength of at least 2 of its pixels,
+  // the first level all of them, and shares those spanning pyramid_share()
+  int octaves = fractal ? settings.octaves : 1;
+  double share = pyramid_share(settings.generator.GetFractalType());
+  std::vector<int> kept(levels, 0);
+  std::vector<int> shared(levels, 0);
+  for (int l = 0; l < levels; ++l) {
+    double spacing = std::ldexp(1.0, l);
+    double wavelength = 1.0 / std::fabs(settings.freq);
+    for (int k = 0; k < octaves; ++k) {
+      if (wavelength >= 2 * spacing) kept[l] = k + 1;
+      if (wavelength >= share * spacing) shared[l] = k + 1;
+      wavelength /= settings.lacunarity;
+    }
+    kept[l] = l == 0 ? octaves : std::max(kept[l], 1);
+    shared[l] = std::min(shared[l], kept[l]);
+  }
+  // The first level only gets octaves from the level above
+  shared[0] = levels > 1 ? shared[1] : 0;
+  if (!fractal) std::fill(shared.begin(), shared.end(), 0);
+
+  bool rigid = fractal && settings.generator.GetFractalType() == FastNoise::RigidMulti;
+  if (settings.single) {
+    FastNoiseT<float> noise_single(settings.generator);
+    return noise_pyramid(noise_single, fractal, rigid, settings.dim[0], settings.dim[1], shared, kept, settings.threads);
+  }
+  return noise_pyramid(settings.generator, fractal, rigid, settings.dim[0], settings.dim[1], shared, kept, settings.threads);
+}
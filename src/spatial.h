@@ -0,0 +1,54 @@
+#ifndef AMBIENT_SPATIAL_H
+#define AMBIENT_SPATIAL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "point_axis.h"
+
+// Lattice cell of a coordinate, biased to be non-negative. Non-finite
+// coordinates all end up in the same cell
+inline uint32_t lattice_cell(double coord, double freq) {
+  double cell = std::floor(coord * freq);
+  if (!(cell > -2147483648.0)) cell = -2147483648.0;
+  if (!(cell < 2147483647.0)) cell = 2147483647.0;
+  return (uint32_t) ((int64_t) cell + 2147483648LL);
+}
+
+// Spread the low bits of `x` out so that there are `stride - 1` zero bits
+// between each of them
+inline uint64_t morton_spread(uint32_t x, int stride) {
+  uint64_t res = 0;
+  int n_bits = 64 / stride;
+  for (int b = 0; b < n_bits; ++b) {
+    res |= (uint64_t) ((x >> b) & 1u) << (b * stride);
+  }
+  return res;
+}
+
+// Returns the point indices ordered along a Morton (Z-order) curve through the
+// lattice cells they fall in, so that points sharing cells (and thus
+// permutation lookups and cellular neighbourhoods) are evaluated together.
+// Only the low bits of each cell are used, which keeps neighbouring cells
+// together while wrapping very distant ones.
+inline std::vector<int> spatial_order(int n, double freq, int n_dim, const PointAxis* coords) {
+  int shift = 32 - 64 / n_dim;
+  std::vector< std::pair<uint64_t, int> > keys(n);
+  for (int i = 0; i < n; ++i) {
+    uint64_t key = 0;
+    for (int d = 0; d < n_dim; ++d) {
+      key |= morton_spread(lattice_cell(coords[d][i], freq) << shift >> shift, n_dim) << d;
+    }
+    keys[i] = std::make_pair(key, i);
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<int> order(n);
+  for (int i = 0; i < n; ++i) {
+    order[i] = keys[i].second;
+  }
+  return order;
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include <cpp11/declarations.hpp>
+#include <cpp11/external_pointer.hpp>
+#include <cpp11/list.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "FastNoise.h"
+#include "generator.h"
+#include "lazy_noise.h"
+#include "mapped_file.h"
+#include "noise.h"
+
+// Tiles of an unbounded noise field for noise_tiles(). Tile (x, y, z) covers
+// the `size` pixels starting at x * size, y * size, and z * size, extended by
+// `halo` pixels on all sides. All tiles are sampled from the same field so
+// neighbouring tiles line up seamlessly and agree where their halos overlap
+struct TileSource {
+  NoiseConfig config;
+  FastNoiseT<float> noise_single;
+  uint64_t hash;
+  int size;
+  int halo;
+};
+
+struct TileKey {
+  uint64_t config;
+  int size;
+  int halo;
+  double x;
+  double y;
+  double z;
+
+  bool operator==(const TileKey& other) const {
+    return config == other.config && size == other.size && halo == other.halo &&
+      x == other.x && y == other.y && z == other.z;
+  }
+};
+
+struct TileKeyHash {
+  std::size_t operator()(const TileKey& key) const {
+    std::hash<double> hash_double;
+    std::size_t hash = (std::size_t) key.config;
+    hash = hash * 31 + (std::size_t) key.size;
+    hash = hash * 31 + (std::size_t) key.halo;
+    hash = hash * 31 + hash_double(key.x);
+    hash = hash * 31 + hash_double(key.y);
+    return hash * 31 + hash_double(key.z);
+  }
+};
+
+typedef std::shared_ptr< const std::vector<double> > TileData;
+
+// The most recently used tiles of all noise_tiles() generators. Tiles are
+// keyed by the hash of the settings they were generated with so generators
+// with identical settings share tiles. The cache is only used from the main
+// thread
+class TileCache {
+public:
+  TileCache() : bytes_(0) {}
+
+  TileData get(const TileKey& key) {
+    auto it = cache_.find(key);
+    if (it == cache_.end()) return TileData();
+    lru_.splice(lru_.begin(), lru_, it->second.second);
+    return it->second.first;
+  }
+
+  // Tiles larger than the whole cache are not kept
+  void put(const TileKey& key, TileData tile, std::size_t limit) {
+    std::size_t size = tile->size() * sizeof(double);
+    if (size <= limit) {
+      lru_.push_front(key);
+      cache_[key] = std::make_pair(tile, lru_.begin());
+      bytes_ += size;
+    }
+    trim(limit);
+  }
+
+  void trim(std::size_t limit) {
+    while (bytes_ > limit) {
+      auto it = cache_.find(lru_.back());
+      bytes_ -= it->second.first->size() * sizeof(double);
+      cache_.erase(it);
+      lru_.pop_back();
+    }
+  }
+
+private:
+  std::list<TileKey> lru_;
+  std::unordered_map< TileKey, std::pair< TileData, std::list<TileKey>::iterator >, TileKeyHash > cache_;
+  std::size_t bytes_;
+};
+
+static TileCache tile_cache;
+
+static TileData compute_tile(const TileSource& source, double x, double y, double z) {
+  const NoiseConfig& config = source.config;
+  int n = source.size + 2 * source.halo;
+  double origin[3] = {
+    x * source.size - source.halo,
+    y * source.size - source.halo,
+    z * source.size - source.halo
+  };
+  std::shared_ptr< std::vector<double> > tile = std::make_shared< std::vector<double> >(
+    (std::size_t) n * n * (config.dims == 3 ? n : 1)
+  );
+  if (config.type == WhiteGen) {
+    white_grid_at(tile->data(), n, config.dims, origin, config.generator, config.pertube, config.single, config.threads);
+  } else if (config.single) {
+    noise_grid_at<float>(tile->data(), n, config.dims, origin, source.noise_single, config.pertube, config.threads);
+  } else {
+    noise_grid_at<double>(tile->data(), n, config.dims, origin, config.generator, config.pertube, config.threads);
+  }
+  return tile;
+}
+
+// Tiles in the on-disk noise cache are stored as the raw values in a directory
+// per tile generator (see noise_tiles_key_c()), named by their index
+static std::string tile_file(SEXP dir, double x, double y, double z) {
+  char name[128];
+  // Adding 0 turns -0 into 0
+  std::snprintf(name, sizeof(name), "/%.0f_%.0f_%.0f.tile", x + 0.0, y + 0.0, z + 0.0);
+  return std::string(CHAR(STRING_ELT(dir, 0))) + name;
+}
+
+static TileData read_tile(const std::string& path, std::size_t length) {
+  MappedFile file;
+  std::string error;
+  if (!file.open(path, error) || file.size() != length * sizeof(double)) {
+    return TileData();
+  }
+  const double* values = (const double*) file.data();
+  TileData tile = std::make_shared< const std::vector<double> >(values, values + length);
+  touch_file(path);
+  return tile;
+}
+
+[[cpp11::register]]
+SEXP noise_tiles_c(cpp11::list config, int size, int halo) {
+  if (size < 1 || size == NA_INTEGER) cpp11::stop("`tile_size` must be positive");
+  if (halo < 0 || halo == NA_INTEGER) cpp11::stop("`halo` can't be negative");
+  NoiseConfig settings = noise_config(config);
+  if (settings.dims > 3) cpp11::stop("Tiles can only be generated in 2 or 3 dimensions");
+  if (settings.dim[0] != size + 2 * halo) cpp11::stop("Tile settings don't match the tile size");
+  cpp11::external_pointer<TileSource> ptr(new TileSource{
+    settings, FastNoiseT<float>(settings.generator), noise_config_hash(settings), size, halo
+  });
+  return ptr;
+}
+
+// The directory of the tiles of a generator in the on-disk noise cache
+[[cpp11::register]]
+std::string noise_tiles_key_c(SEXP tiles) {
+  cpp11::external_pointer<TileSource> ptr(tiles);
+  const TileSource* source = ptr.get();
+  if (source == nullptr) {
+    cpp11::stop("The tile generator is no longer valid. Generators can't be saved and restored across sessions");
+  }
+  return hash_key(source->hash) + "-" + std::to_string(source->size) + "-" + std::to_string(source->halo);
+}
+
+// `dir` is the directory of the tiles in the on-disk noise cache, or NULL if
+// tiles are only cached in memory. Tiles not in memory are looked up there
+// before they are generated, and generated tiles are added to it
+[[cpp11::register]]
+SEXP noise_tile_c(SEXP tiles, double x, double y, double z, double cache_size, SEXP dir) {
+  cpp11::external_pointer<TileSource> ptr(tiles);
+  const TileSource* source = ptr.get();
+  if (source == nullptr) {
+    cpp11::stop("The tile generator is no longer valid. Generators can't be saved and restored across sessions");
+  }
+  int dims = source->config.dims;
+  if (dims == 2) z = 0;
+  std::size_t limit = cache_size > 0 ? (std::size_t) cache_size : 0;
+
+  TileKey key = {source->hash, source->size, source->halo, x, y, z};
+  int n = source->size + 2 * source->halo;
+  TileData tile = tile_cache.get(key);
+  if (!tile) {
+    std::string path;
+    if (TYPEOF(dir) == STRSXP && Rf_xlength(dir) == 1) {
+      path = tile_file(dir, x, y, z);
+      tile = read_tile(path, (std::size_t) n * n * (dims == 3 ? n : 1));
+    }
+    if (!tile) {
+      tile = compute_tile(*source, x, y, z);
+      // The disk cache is best effort so failing writes are ignored
+      if (!path.empty()) write_file_atomic(path, tile->data(), tile->size() * sizeof(double));
+    }
+    tile_cache.put(key, tile, limit);
+  } else {
+    tile_cache.trim(limit);
+  }
+
+  SEXP noise = PROTECT(Rf_allocVector(REALSXP, tile->size()));
+  std::copy(tile->begin(), tile->end(), REAL(noise));
+  SEXP dim = PROTECT(Rf_allocVector(INTSXP, dims));
+  std::fill(INTEGER(dim), INTEGER(dim) + dims, n);
+  Rf_setAttrib(noise, R_DimSymbol, dim);
+  UNPROTECT(2);
+  return noise;
+}
@@ -1,14 +1,20 @@
 #include <cpp11/matrix.hpp>
 #include <cpp11/doubles.hpp>
 #include "FastNoise.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "noise.h"
+#include "spatial.h"
 
 FastNoise value_c(int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp) {
   FastNoise noise_gen;
-  noise_gen.SetSeed(seed);
+  noise_gen.SetSeed(seed, seed_mode());
   noise_gen.SetFrequency(freq);
   noise_gen.SetInterp((FastNoise::Interp) interp);
+  noise_gen.SetNoiseType(FastNoise::Value);
   if (pertube != 0) noise_gen.SetGradientPerturbAmp(pertube_amp);
   if (fractal != 0) {
+    noise_gen.SetNoiseType(FastNoise::ValueFractal);
     noise_gen.SetFractalType((FastNoise::FractalType) (fractal - 1));
     noise_gen.SetFractalOctaves(octaves);
     noise_gen.SetFractalLacunarity(lacunarity);
@@ -19,81 +25,63 @@ FastNoise value_c(int seed, double freq, int interp, int fractal, int octaves, d
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles_matrix<> value_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp) {
+cpp11::writable::doubles_matrix<> value_2d_c(int height, int width, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single) {
   cpp11::writable::doubles_matrix<> noise(height, width);
-  int i,j;
-  double new_i, new_j;
-  FastNoise noise_gen = value_c(seed, freq, interp, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
-
-  for (i = 0; i < height; ++i) {
-    for (j = 0; j < width; ++j) {
-      new_i = (double) i;
-      new_j = (double) j;
+  double* out = REAL(noise.data());
 
-      if (pertube == 1) {
-        noise_gen.GradientPerturb(new_j, new_i);
-      } else if (pertube == 2) {
-        noise_gen.GradientPerturbFractal(new_j, new_i);
-      }
-      if (fractal == 0) {
-        noise(i, j) = noise_gen.GetValue(new_j, new_i);
-      } else {
-        noise(i, j) = noise_gen.GetValueFractal(new_j, new_i);
-      }
-    }
+  FastNoise noise_gen = value_c(seed, freq, interp, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
+  if (single) {
+    noise_grid_2d(out, height, width, FastNoiseT<float>(noise_gen), pertube, threads);
+  } else {
+    noise_grid_2d(out, height, width, noise_gen, pertube, threads);
   }
 
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles_matrix<> value_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp) {
+cpp11::writable::doubles_matrix<> value_3d_c(int height, int width, int depth, int seed, double freq, int interp, int fractal, int octaves, double lacunarity, double gain, int pertube, double pertube_amp, int threads, bool single) {
   cpp11::writable::doubles_matrix<> noise(height, width * depth);
-  int i,j,k;
-  double new_i, new_j, new_k;
+  double* out = REAL(noise.data());
 
   FastNoise noise_gen = value_c(seed, freq, interp, fractal, octaves, lacunarity, gain, pertube, pertube_amp);
-
-  for (k = 0; k < depth; ++k) {
-    for (i = 0; i < height; ++i) {
-      for (j = 0; j < width; ++j) {
-        new_i = (double) i;
-        new_j = (double) j;
-        new_k = (double) k;
-
-        if (pertube == 1) {
-          noise_gen.GradientPerturb(new_j, new_i, new_k);
-        } else if (pertube == 2) {
-          noise_gen.GradientPerturbFractal(new_j, new_i, new_k);
-        }
-        if (fractal == 0) {
-          noise(i, j + k * width) = noise_gen.GetValue(new_j, new_i, new_k);
-        } else {
-          noise(i, j + k * width) = noise_gen.GetValueFractal(new_j, new_i, new_k);
-        }
-      }
-    }
+  if (single) {
+    noise_grid_3d(out, height, width, depth, FastNoiseT<float>(noise_gen), pertube, threads);
+  } else {
+    noise_grid_3d(out, height, width, depth, noise_gen, pertube, threads);
   }
 
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles gen_value2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp) {
+cpp11::writable::doubles gen_value2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int interp, int threads, bool presort, bool single) {
   cpp11::writable::doubles noise(x.size());
+  double* out = REAL(noise.data());
+  const PointAxis coords[] = {point_axis(x), point_axis(y)};
   FastNoise generator = value_c(seed, freq, interp, 0, 0, 0.0, 0.0, 0, 0.0);
-  for (int i = 0; i < x.size(); i++) {
-    noise[i] = generator.GetValue(x[i], y[i]);
+  std::vector<int> order;
+  if (presort) order = spatial_order(x.size(), freq, 2, coords);
+  if (single) {
+    noise_points<2>(out, x.size(), coords, FastNoiseT<float>(generator), order, threads);
+  } else {
+    noise_points<2>(out, x.size(), coords, generator, order, threads);
   }
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles gen_value3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp) {
+cpp11::writable::doubles gen_value3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int interp, int threads, bool presort, bool single) {
   cpp11::writable::doubles noise(x.size());
+  double* out = REAL(noise.data());
+  const PointAxis coords[] = {point_axis(x), point_axis(y), point_axis(z)};
   FastNoise generator = value_c(seed, freq, interp, 0, 0, 0.0, 0.0, 0, 0.0);
-  for (int i = 0; i < x.size(); i++) {
-    noise[i] = generator.GetValue(x[i], y[i], z[i]);
+  std::vector<int> order;
+  if (presort) order = spatial_order(x.size(), freq, 3, coords);
+  if (single) {
+    noise_points<3>(out, x.size(), coords, FastNoiseT<float>(generator), order, threads);
+  } else {
+    noise_points<3>(out, x.size(), coords, generator, order, threads);
   }
   return noise;
 }
@@ -0,0 +1,283 @@
+#include <cpp11/declarations.hpp>
+#include <cpp11/external_pointer.hpp>
+#include <cpp11/list.hpp>
+#include <cpp11/protect.hpp>
+#include <R_ext/Altrep.h>
+#include <R_ext/Rdynload.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lazy_noise.h"
+#include "mapped_file.h"
+
+// Noise grids streamed to disk with noise_*(file = ). The file starts with a
+// header of `volume_header_size` bytes beginning with a VolumeHeader, followed
+// by the noise in the column-major order of R arrays. Values are stored in
+// native byte order as doubles, or as floats for single precision noise
+static const char volume_magic[8] = {'A', 'M', 'B', 'N', 'O', 'I', 'S', 'E'};
+static const uint32_t volume_version = 1;
+static const uint32_t volume_header_size = 4096;
+
+enum VolumeType { VolumeDouble, VolumeFloat };
+
+// The layout of the grid along with the settings it was generated with. Unused
+// dimensions are 1
+struct VolumeHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t dtype;
+  uint32_t dims;
+  int64_t dim[4];
+  double freq;
+  double lacunarity;
+  double gain;
+  double jitter;
+  double pertube_amp;
+  int32_t type;
+  int32_t seed;
+  int32_t interp;
+  int32_t fractal;
+  int32_t octaves;
+  int32_t dist;
+  int32_t value;
+  int32_t dist2ind[2];
+  int32_t pertube;
+  int32_t seeding;
+};
+static_assert(sizeof(VolumeHeader) <= volume_header_size, "The volume header must fit in the reserved space");
+
+static VolumeHeader volume_header(const NoiseConfig& config) {
+  VolumeHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, volume_magic, sizeof(volume_magic));
+  header.version = volume_version;
+  header.header_size = volume_header_size;
+  header.dtype = config.single ? VolumeFloat : VolumeDouble;
+  header.dims = config.dims;
+  for (int d = 0; d < 4; ++d) {
+    header.dim[d] = config.dim[d];
+  }
+  header.freq = config.freq;
+  header.lacunarity = config.lacunarity;
+  header.gain = config.gain;
+  header.jitter = config.jitter;
+  header.pertube_amp = config.pertube_amp;
+  header.type = config.type;
+  header.seed = config.seed;
+  header.interp = config.interp;
+  header.fractal = config.fractal;
+  header.octaves = config.octaves;
+  header.dist = config.dist;
+  header.value = config.value;
+  header.dist2ind[0] = config.dist2ind[0];
+  header.dist2ind[1] = config.dist2ind[1];
+  header.pertube = config.pertube;
+  header.seeding = config.seeding;
+  return header;
+}
+
+struct FileCloser {
+  void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+inline void volume_write(std::FILE* file, const void* data, std::size_t size, const std::string& path) {
+  if (std::fwrite(data, 1, size, file) != size) {
+    cpp11::stop("Unable to write to '%s'", path.c_str());
+  }
+}
+
+// Generates the grid one slab (a matrix of the volume) at a time and appends
+// it to the file, so memory use is bounded by a single slab
+[[cpp11::register]]
+void noise_file_c(cpp11::list config, std::string path) {
+  NoiseConfig settings = noise_config(config);
+  std::unique_ptr<LazyTiles> tiles(noise_config_tiles(settings));
+  std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.c_str(), "wb"));
+  if (!file) cpp11::stop("Unable to open '%s' for writing", path.c_str());
+
+  std::vector<unsigned char> header(volume_header_size, 0);
+  VolumeHeader info = volume_header(settings);
+  std::memcpy(header.data(), &info, sizeof(info));
+  volume_write(file.get(), header.data(), header.size(), path);
+
+  std::size_t slab_size = (std::size_t) tiles->height * tiles->width;
+  std::vector<double> slab(slab_size);
+  std::vector<float> slab_single(settings.single ? slab_size : 0);
+  for (int s = 0; s < tiles->slabs; ++s) {
+    tiles->fill_slabs(s, 1, slab.data(), settings.threads);
+    if (settings.single) {
+      std::copy(slab.begin(), slab.end(), slab_single.begin());
+      volume_write(file.get(), slab_single.data(), slab_size * sizeof(float), path);
+    } else {
+      volume_write(file.get(), slab.data(), slab_size * sizeof(double), path);
+    }
+    cpp11::check_user_interrupt();
+  }
+  if (std::fclose(file.release()) != 0) {
+    cpp11::stop("Unable to write to '%s'", path.c_str());
+  }
+}
+
+// Volumes read back with read_noise() are ALTREP vectors of the mapped file.
+// data1 holds list(<MappedVolume>, path) and data2 the materialised vector
+// once something asks for a writable pointer to the data
+static R_altrep_class_t mapped_noise_class;
+
+struct MappedVolume {
+  MappedFile file;
+  VolumeHeader header;
+  R_xlen_t length;
+
+  const double* doubles() const {
+    return (const double*) (file.data() + header.header_size);
+  }
+  const float* floats() const {
+    return (const float*) (file.data() + header.header_size);
+  }
+};
+
+inline MappedVolume* mapped_state(SEXP x) {
+  cpp11::external_pointer<MappedVolume> ptr(VECTOR_ELT(R_altrep_data1(x), 0));
+  return ptr.get();
+}
+
+static SEXP new_mapped_noise(SEXP path) {
+  std::string file = cpp11::as_cpp<std::string>(path);
+  std::unique_ptr<MappedVolume> volume(new MappedVolume());
+  std::string error;
+  if (!volume->file.open(file, error)) {
+    cpp11::stop("Unable to read '%s': %s", file.c_str(), error.c_str());
+  }
+  if (volume->file.size() < sizeof(VolumeHeader)) {
+    cpp11::stop("'%s' is not a noise file", file.c_str());
+  }
+  VolumeHeader& header = volume->header;
+  std::memcpy(&header, volume->file.data(), sizeof(header));
+  if (std::memcmp(header.magic, volume_magic, sizeof(volume_magic)) != 0) {
+    cpp11::stop("'%s' is not a noise file", file.c_str());
+  }
+  if (header.version != volume_version || header.header_size != volume_header_size) {
+    cpp11::stop("'%s' was written by an incompatible version of ambient", file.c_str());
+  }
+  if (header.dims < 2 || header.dims > 4 || (header.dtype != VolumeDouble && header.dtype != VolumeFloat)) {
+    cpp11::stop("'%s' has a malformed header", file.c_str());
+  }
+  volume->length = 1;
+  for (uint32_t d = 0; d < header.dims; ++d) {
+    if (header.dim[d] < 0 || header.dim[d] > INT_MAX) {
+      cpp11::stop("'%s' has a malformed header", file.c_str());
+    }
+    volume->length *= (R_xlen_t) header.dim[d];
+  }
+  std::size_t value_size = header.dtype == VolumeDouble ? sizeof(double) : sizeof(float);
+  if (volume->file.size() != header.header_size + (std::size_t) volume->length * value_size) {
+    cpp11::stop("'%s' is truncated", file.c_str());
+  }
+
+  SEXP dim = PROTECT(Rf_allocVector(INTSXP, header.dims));
+  for (uint32_t d = 0; d < header.dims; ++d) {
+    INTEGER(dim)[d] = (int) header.dim[d];
+  }
+  cpp11::external_pointer<MappedVolume> state(volume.release());
+  SEXP data1 = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(data1, 0, state);
+  SET_VECTOR_ELT(data1, 1, path);
+  SEXP noise = PROTECT(R_new_altrep(mapped_noise_class, data1, R_NilValue));
+  Rf_setAttrib(noise, R_DimSymbol, dim);
+  UNPROTECT(3);
+  return noise;
+}
+
+static R_xlen_t mapped_length(SEXP x) {
+  return mapped_state(x)->length;
+}
+
+static double mapped_elt(SEXP x, R_xlen_t i) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) return REAL(materialised)[i];
+  const MappedVolume* volume = mapped_state(x);
+  if (volume->header.dtype == VolumeDouble) return volume->doubles()[i];
+  return volume->floats()[i];
+}
+
+static R_xlen_t mapped_get_region(SEXP x, R_xlen_t i, R_xlen_t n, double* buf) {
+  SEXP materialised = R_altrep_data2(x);
+  const MappedVolume* volume = mapped_state(x);
+  n = std::min(n, volume->length - i);
+  if (n <= 0) return 0;
+  if (materialised != R_NilValue) {
+    std::copy(REAL(materialised) + i, REAL(materialised) + i + n, buf);
+  } else if (volume->header.dtype == VolumeDouble) {
+    std::copy(volume->doubles() + i, volume->doubles() + i + n, buf);
+  } else {
+    std::copy(volume->floats() + i, volume->floats() + i + n, buf);
+  }
+  return n;
+}
+
+// The mapping is read-only so writable access gets a copy
+static void* mapped_dataptr(SEXP x, Rboolean) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised == R_NilValue) {
+    R_xlen_t length = mapped_state(x)->length;
+    materialised = PROTECT(Rf_allocVector(REALSXP, length));
+    mapped_get_region(x, 0, length, REAL(materialised));
+    R_set_altrep_data2(x, materialised);
+    UNPROTECT(1);
+  }
+  return REAL(materialised);
+}
+
+// Read-only access to double volumes goes straight to the mapping
+static const void* mapped_dataptr_or_null(SEXP x) {
+  SEXP materialised = R_altrep_data2(x);
+  if (materialised != R_NilValue) return REAL(materialised);
+  const MappedVolume* volume = mapped_state(x);
+  if (volume->header.dtype == VolumeDouble) return volume->doubles();
+  return nullptr;
+}
+
+// Saved as the path of the file, which must still exist when read back.
+// Materialised volumes may have been modified and are saved as ordinary
+// vectors
+static SEXP mapped_serialized_state(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  return VECTOR_ELT(R_altrep_data1(x), 1);
+}
+
+static SEXP mapped_unserialize(SEXP, SEXP state) {
+  BEGIN_CPP11
+  return new_mapped_noise(state);
+  END_CPP11
+}
+
+// Copies share the mapping until they are modified
+static SEXP mapped_duplicate(SEXP x, Rboolean) {
+  if (R_altrep_data2(x) != R_NilValue) return nullptr;
+  return R_new_altrep(mapped_noise_class, R_altrep_data1(x), R_NilValue);
+}
+
+[[cpp11::register]]
+SEXP noise_read_c(SEXP path) {
+  if (TYPEOF(path) != STRSXP || Rf_xlength(path) != 1) cpp11::stop("`file` must be a single path");
+  return new_mapped_noise(path);
+}
+
+[[cpp11::init]]
+void init_mapped_noise(DllInfo* dll) {
+  mapped_noise_class = R_make_altreal_class("mapped_noise", "ambient", dll);
+  R_set_altrep_Length_method(mapped_noise_class, mapped_length);
+  R_set_altrep_Serialized_state_method(mapped_noise_class, mapped_serialized_state);
+  R_set_altrep_Unserialize_method(mapped_noise_class, mapped_unserialize);
+  R_set_altrep_Duplicate_method(mapped_noise_class, mapped_duplicate);
+  R_set_altvec_Dataptr_method(mapped_noise_class, mapped_dataptr);
+  R_set_altvec_Dataptr_or_null_method(mapped_noise_class, mapped_dataptr_or_null);
+  R_set_altreal_Elt_method(mapped_noise_class, mapped_elt);
+  R_set_altreal_Get_region_method(mapped_noise_class, mapped_get_region);
+}
@@ -1,123 +1,215 @@
 #include <cpp11/matrix.hpp>
 #include <cpp11/doubles.hpp>
+#include <algorithm>
+#include <vector>
 #include "FastNoise.h"
+#include "generator.h"
+#include "grid_axis.h"
+#include "lazy_noise.h"
+#include "noise.h"
+#include "parallel.h"
+#include "spatial.h"
 
-[[cpp11::register]]
-cpp11::writable::doubles_matrix<> white_2d_c(int height, int width, int seed, double freq, int pertube, double pertube_amp) {
-  cpp11::writable::doubles_matrix<> noise(height, width);
-  int i,j;
-  double new_i, new_j;
+FastNoise white_c(int seed, double freq, int pertube, double pertube_amp) {
   FastNoise noise_gen;
-  noise_gen.SetSeed(seed);
+  noise_gen.SetSeed(seed, seed_mode());
   noise_gen.SetFrequency(freq);
   if (pertube != 0) noise_gen.SetGradientPerturbAmp(pertube_amp);
 
-  for (i = 0; i < height; ++i) {
-    for (j = 0; j < width; ++j) {
-      new_i = (double) i;
-      new_j = (double) j;
+  return noise_gen;
+}
+
+// Rows of white noise for parallel_grid(). Perturbation is applied to a whole
+// row of coordinates before looking up. Slab `s` lies at z = s % depth and
+// t = s / depth. 2D and 3D grids can be moved away from the origin with `x0`,
+// `y0`, and `z0`
+template <typename T>
+class WhiteRows {
+public:
+  WhiteRows(const FastNoiseT<T>& noise_gen, int dims, int depth, int pertube, double x0 = 0, double y0 = 0, double z0 = 0) :
+    noise_gen_(noise_gen), dims_(dims), depth_(depth), pertube_(pertube),
+    x0_(x0), y0_(y0), z0_(z0), coords_(3 * grid_tile_cols) {}
 
-      if (pertube == 1) {
-        noise_gen.GradientPerturb(new_j, new_i);
-      } else if (pertube == 2) {
-        noise_gen.GradientPerturbFractal(new_j, new_i);
+  void operator()(int i, int slab, int j, int n, T* res) {
+    if (dims_ == 4) {
+      int k = slab % depth_;
+      int l = slab / depth_;
+      for (int c = 0; c < n; ++c) {
+        res[c] = noise_gen_.GetWhiteNoiseInt(j + c, i, k, l);
+      }
+      return;
+    }
+    T* coords[] = {coords_.data(), coords_.data() + grid_tile_cols, coords_.data() + 2 * grid_tile_cols};
+    for (int c = 0; c < n; ++c) {
+      coords[0][c] = (T) (x0_ + (j + c));
+    }
+    std::fill(coords[1], coords[1] + n, (T) (y0_ + i));
+    std::fill(coords[2], coords[2] + n, (T) (z0_ + slab));
+    if (pertube_ != 0) {
+      noise_gen_.GradientPerturbBatch(dims_, coords, n, pertube_ == 2);
+    }
+    if (dims_ == 2) {
+      for (int c = 0; c < n; ++c) {
+        res[c] = noise_gen_.GetWhiteNoiseInt(coords[0][c], coords[1][c]);
+      }
+    } else {
+      for (int c = 0; c < n; ++c) {
+        res[c] = noise_gen_.GetWhiteNoiseInt(coords[0][c], coords[1][c], coords[2][c]);
       }
-      noise(i, j) = noise_gen.GetWhiteNoiseInt(new_j, new_i);
     }
   }
 
+private:
+  const FastNoiseT<T>& noise_gen_;
+  int dims_;
+  int depth_;
+  int pertube_;
+  double x0_;
+  double y0_;
+  double z0_;
+  std::vector<T> coords_;
+};
+
+template <typename T>
+void white_grid_2d(double* out, int height, int width, const FastNoiseT<T>& noise_gen, int pertube, int threads) {
+  parallel_grid<T>(out, height, width, 1, threads, WhiteRows<T>(noise_gen, 2, 1, pertube));
+}
+
+template <typename T>
+void white_grid_3d(double* out, int height, int width, int depth, const FastNoiseT<T>& noise_gen, int pertube, int threads) {
+  parallel_grid<T>(out, height, width, depth, threads, WhiteRows<T>(noise_gen, 3, depth, pertube));
+}
+
+template <typename T>
+void white_grid_4d(double* out, int height, int width, int depth, int time, const FastNoiseT<T>& noise_gen, int threads) {
+  parallel_grid<T>(out, height, width, depth * time, threads, WhiteRows<T>(noise_gen, 4, depth, 0));
+}
+
+template <typename T>
+void white_points_2d(double* out, int n, const PointAxis* coords, const FastNoiseT<T>& generator, const std::vector<int>& order, int threads) {
+  parallel_points(n, threads, order, [&](int i) {
+    out[i] = generator.GetWhiteNoise((T) coords[0][i], (T) coords[1][i]);
+  });
+}
+
+template <typename T>
+void white_points_3d(double* out, int n, const PointAxis* coords, const FastNoiseT<T>& generator, const std::vector<int>& order, int threads) {
+  parallel_points(n, threads, order, [&](int i) {
+    out[i] = generator.GetWhiteNoise((T) coords[0][i], (T) coords[1][i], (T) coords[2][i]);
+  });
+}
+
+template <typename T>
+void white_points_4d(double* out, int n, const PointAxis* coords, const FastNoiseT<T>& generator, const std::vector<int>& order, int threads) {
+  parallel_points(n, threads, order, [&](int i) {
+    out[i] = generator.GetWhiteNoise((T) coords[0][i], (T) coords[1][i], (T) coords[2][i], (T) coords[3][i]);
+  });
+}
+
+LazyTiles* white_lazy_tiles(const FastNoise& noise_gen, int height, int width, int depth, int time, int dims, int pertube, bool single) {
+  if (dims == 4) pertube = 0;
+  if (single) {
+    return new LazyTilesT< float, WhiteRows<float> >(noise_gen, height, width, depth * time, dims, depth, pertube);
+  }
+  return new LazyTilesT< double, WhiteRows<double> >(noise_gen, height, width, depth * time, dims, depth, pertube);
+}
+
+void white_grid_at(double* out, int size, int dims, const double* origin, const FastNoise& noise_gen, int pertube, bool single, int threads) {
+  int depth = dims == 3 ? size : 1;
+  if (single) {
+    FastNoiseT<float> noise_single(noise_gen);
+    parallel_grid<float>(out, size, size, depth, threads, WhiteRows<float>(noise_single, dims, depth, pertube, origin[0], origin[1], origin[2]));
+  } else {
+    parallel_grid<double>(out, size, size, depth, threads, WhiteRows<double>(noise_gen, dims, depth, pertube, origin[0], origin[1], origin[2]));
+  }
+}
+
+[[cpp11::register]]
+cpp11::writable::doubles_matrix<> white_2d_c(int height, int width, int seed, double freq, int pertube, double pertube_amp, int threads, bool single) {
+  cpp11::writable::doubles_matrix<> noise(height, width);
+  double* out = REAL(noise.data());
+  FastNoise noise_gen = white_c(seed, freq, pertube, pertube_amp);
+  if (single) {
+    white_grid_2d(out, height, width, FastNoiseT<float>(noise_gen), pertube, threads);
+  } else {
+    white_grid_2d(out, height, width, noise_gen, pertube, threads);
+  }
+
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles_matrix<> white_3d_c(int height, int width, int depth, int seed, double freq, int pertube, double pertube_amp) {
+cpp11::writable::doubles_matrix<> white_3d_c(int height, int width, int depth, int seed, double freq, int pertube, double pertube_amp, int threads, bool single) {
   cpp11::writable::doubles_matrix<> noise(height, width * depth);
-  int i,j,k;
-  double new_i, new_j, new_k;
-  FastNoise noise_gen;
-  noise_gen.SetSeed(seed);
-  noise_gen.SetFrequency(freq);
-  if (pertube != 0) noise_gen.SetGradientPerturbAmp(pertube_amp);
-
-  for (k = 0; k < depth; ++k) {
-    for (i = 0; i < height; ++i) {
-      for (j = 0; j < width; ++j) {
-        new_i = (double) i;
-        new_j = (double) j;
-        new_k = (double) k;
-
-        if (pertube == 1) {
-          noise_gen.GradientPerturb(new_j, new_i, new_k);
-        } else if (pertube == 2) {
-          noise_gen.GradientPerturbFractal(new_j, new_i, new_k);
-        }
-        noise(i, j + k * width) = noise_gen.GetWhiteNoiseInt(new_j, new_i, new_k);
-      }
-    }
+  double* out = REAL(noise.data());
+  FastNoise noise_gen = white_c(seed, freq, pertube, pertube_amp);
+  if (single) {
+    white_grid_3d(out, height, width, depth, FastNoiseT<float>(noise_gen), pertube, threads);
+  } else {
+    white_grid_3d(out, height, width, depth, noise_gen, pertube, threads);
   }
 
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles_matrix<> white_4d_c(int height, int width, int depth, int time, int seed, double freq, int pertube, double pertube_amp) {
+cpp11::writable::doubles_matrix<> white_4d_c(int height, int width, int depth, int time, int seed, double freq, int pertube, double pertube_amp, int threads, bool single) {
   cpp11::writable::doubles_matrix<> noise(height, width * depth * time);
-  int i,j,k,l;
-  double new_i, new_j, new_k, new_l;
-  FastNoise noise_gen;
-  noise_gen.SetSeed(seed);
-  noise_gen.SetFrequency(freq);
-
-  for (l = 0; l < time; ++l) {
-    for (k = 0; k < depth; ++k) {
-      for (i = 0; i < height; ++i) {
-        for (j = 0; j < width; ++j) {
-          new_i = (double) i;
-          new_j = (double) j;
-          new_k = (double) k;
-          new_l = (double) l;
-
-          noise(i, j + k * width + l * width * depth) = noise_gen.GetWhiteNoiseInt(new_j, new_i, new_k, new_l);
-        }
-      }
-    }
+  double* out = REAL(noise.data());
+  FastNoise noise_gen = white_c(seed, freq, 0, 0.0);
+  if (single) {
+    white_grid_4d(out, height, width, depth, time, FastNoiseT<float>(noise_gen), threads);
+  } else {
+    white_grid_4d(out, height, width, depth, time, noise_gen, threads);
   }
 
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles gen_white2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed) {
+cpp11::writable::doubles gen_white2d_c(cpp11::doubles x, cpp11::doubles y, double freq, int seed, int threads, bool presort, bool single) {
   cpp11::writable::doubles noise(x.size());
-  FastNoise generator;
-  generator.SetSeed(seed);
-  generator.SetFrequency(freq);
-  for (int i = 0; i < x.size(); i++) {
-    noise[i] = generator.GetWhiteNoise(x[i], y[i]);
+  double* out = REAL(noise.data());
+  const PointAxis coords[] = {point_axis(x), point_axis(y)};
+  FastNoise generator = white_c(seed, freq, 0, 0.0);
+  std::vector<int> order;
+  if (presort) order = spatial_order(x.size(), freq, 2, coords);
+  if (single) {
+    white_points_2d(out, x.size(), coords, FastNoiseT<float>(generator), order, threads);
+  } else {
+    white_points_2d(out, x.size(), coords, generator, order, threads);
   }
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles gen_white3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed) {
+cpp11::writable::doubles gen_white3d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, double freq, int seed, int threads, bool presort, bool single) {
   cpp11::writable::doubles noise(x.size());
-  FastNoise generator;
-  generator.SetSeed(seed);
-  generator.SetFrequency(freq);
-  for (int i = 0; i < x.size(); i++) {
-    noise[i] = generator.GetWhiteNoise(x[i], y[i], z[i]);
+  double* out = REAL(noise.data());
+  const PointAxis coords[] = {point_axis(x), point_axis(y), point_axis(z)};
+  FastNoise generator = white_c(seed, freq, 0, 0.0);
+  std::vector<int> order;
+  if (presort) order = spatial_order(x.size(), freq, 3, coords);
+  if (single) {
+    white_points_3d(out, x.size(), coords, FastNoiseT<float>(generator), order, threads);
+  } else {
+    white_points_3d(out, x.size(), coords, generator, order, threads);
   }
   return noise;
 }
 
 [[cpp11::register]]
-cpp11::writable::doubles gen_white4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed) {
+cpp11::writable::doubles gen_white4d_c(cpp11::doubles x, cpp11::doubles y, cpp11::doubles z, cpp11::doubles t, double freq, int seed, int threads, bool presort, bool single) {
   cpp11::writable::doubles noise(x.size());
-  FastNoise generator;
-  generator.SetSeed(seed);
-  generator.SetFrequency(freq);
-  for (int i = 0; i < x.size(); i++) {
-    noise[i] = generator.GetWhiteNoise(x[i], y[i], z[i], t[i]);
+  double* out = REAL(noise.data());
+  const PointAxis coords[] = {point_axis(x), point_axis(y), point_axis(z), point_axis(t)};
+  FastNoise generator = white_c(seed, freq, 0, 0.0);
+  std::vector<int> order;
+  if (presort) order = spatial_order(x.size(), freq, 4, coords);
+  if (single) {
+    white_points_4d(out, x.size(), coords, FastNoiseT<float>(generator), order, threads);
+  } else {
+    white_points_4d(out, x.size(), coords, generator, order, threads);
   }
   return noise;
 }